@@ -0,0 +1,392 @@
+// =====================================================================================
+// Allocator - Monotonic Arena Allocator
+// =====================================================================================
+
+#include <cstddef>
+#include <new>
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "../Global/Dummy.h"
+#include "../Global/Benchmark.h"
+
+namespace AllocatorArena {
+
+    // monotonic arena: an allocation bumps a pointer, a deallocation does nothing.
+    // Memory is released in bulk - by 'reset' or at the end of an 'ArenaScope'.
+    // The arena is a std::pmr::memory_resource, so it works with std::pmr containers
+    // and can be the upstream of another arena
+    class Arena : public std::pmr::memory_resource
+    {
+    private:
+        // header of a chunk obtained from the upstream resource
+        struct Chunk {
+            Chunk* m_previous;
+            size_t m_size;
+        };
+
+        char* m_buffer;         // initial buffer, not owned
+        size_t m_bufferSize;
+        char* m_current;
+        char* m_end;
+        Chunk* m_chunks;        // newest chunk first
+        Chunk* m_spareChunks;   // released by 'rewind', reused before asking upstream
+        size_t m_nextChunkSize;
+        std::pmr::memory_resource* m_upstream;  // nullptr: no fallback, std::bad_alloc when exhausted
+
+    public:
+        static constexpr size_t DefaultChunkSize{ 4096 };
+
+        // position of the arena, restored at the end of a scope
+        struct Marker {
+            char* m_current;
+            char* m_end;
+            Chunk* m_chunks;
+            size_t m_nextChunkSize;
+        };
+
+        // c'tors and d'tor
+        explicit Arena(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+        Arena(void* buffer, size_t size, std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+        ~Arena();
+
+        // no copy semantics: allocators refer to their arena
+        Arena(const Arena&) = delete;
+        Arena& operator= (const Arena&) = delete;
+
+        // releases everything, also to the upstream resource
+        void reset();
+
+        Marker mark() const;
+        void rewind(const Marker& marker);
+
+        // getter
+        size_t chunks() const;
+        std::pmr::memory_resource* upstream() const { return m_upstream; }
+
+    private:
+        // std::pmr::memory_resource interface
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        void* allocateChunk(size_t bytes, size_t alignment);
+        Chunk* takeSpareChunk(size_t size);
+        void releaseChunks(Chunk* last);
+    };
+
+    Arena::Arena(std::pmr::memory_resource* upstream)
+        : Arena{ nullptr, 0, upstream } {}
+
+    Arena::Arena(void* buffer, size_t size, std::pmr::memory_resource* upstream)
+        : m_buffer{ static_cast<char*>(buffer) }, m_bufferSize{ size },
+          m_current{ m_buffer }, m_end{ m_buffer + size }, m_chunks{ nullptr }, m_spareChunks{ nullptr },
+          m_nextChunkSize{ std::max(size, DefaultChunkSize) }, m_upstream{ upstream } {}
+
+    Arena::~Arena()
+    {
+        reset();
+    }
+
+    void Arena::reset()
+    {
+        releaseChunks(nullptr);
+
+        while (m_spareChunks != nullptr) {
+            Chunk* previous{ m_spareChunks->m_previous };
+            m_upstream->deallocate(m_spareChunks, m_spareChunks->m_size, alignof(std::max_align_t));
+            m_spareChunks = previous;
+        }
+
+        m_current = m_buffer;
+        m_end = m_buffer + m_bufferSize;
+        m_nextChunkSize = std::max(m_bufferSize, DefaultChunkSize);
+    }
+
+    Arena::Marker Arena::mark() const
+    {
+        return { m_current, m_end, m_chunks, m_nextChunkSize };
+    }
+
+    // chunks obtained after 'mark' are kept for the next scope
+    void Arena::rewind(const Marker& marker)
+    {
+        releaseChunks(marker.m_chunks);
+        m_current = marker.m_current;
+        m_end = marker.m_end;
+        m_nextChunkSize = marker.m_nextChunkSize;
+    }
+
+    size_t Arena::chunks() const
+    {
+        size_t count{};
+        for (Chunk* chunk{ m_chunks }; chunk != nullptr; chunk = chunk->m_previous) {
+            ++count;
+        }
+        return count;
+    }
+
+    void* Arena::do_allocate(size_t bytes, size_t alignment)
+    {
+        void* ptr{ m_current };
+        size_t space{ static_cast<size_t>(m_end - m_current) };
+
+        if (m_current == nullptr || std::align(alignment, bytes, ptr, space) == nullptr) {
+            return allocateChunk(bytes, alignment);
+        }
+
+        m_current = static_cast<char*>(ptr) + bytes;
+        return ptr;
+    }
+
+    // chunks grow geometrically, the rest of the current chunk is abandoned
+    void* Arena::allocateChunk(size_t bytes, size_t alignment)
+    {
+        if (m_upstream == nullptr) {
+            throw std::bad_alloc{};
+        }
+
+        size_t size{ std::max(m_nextChunkSize, sizeof(Chunk) + alignment + bytes) };
+
+        Chunk* chunk{ takeSpareChunk(size) };
+        if (chunk == nullptr) {
+            chunk = static_cast<Chunk*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+            chunk->m_size = size;
+        }
+        m_nextChunkSize = 2 * size;
+
+        chunk->m_previous = m_chunks;
+        m_chunks = chunk;
+
+        m_current = reinterpret_cast<char*>(chunk) + sizeof(Chunk);
+        m_end = reinterpret_cast<char*>(chunk) + chunk->m_size;
+
+        void* ptr{ m_current };
+        size_t space{ static_cast<size_t>(m_end - m_current) };
+        std::align(alignment, bytes, ptr, space);
+        m_current = static_cast<char*>(ptr) + bytes;
+        return ptr;
+    }
+
+    // first spare chunk with at least 'size' bytes
+    Arena::Chunk* Arena::takeSpareChunk(size_t size)
+    {
+        for (Chunk** link{ &m_spareChunks }; *link != nullptr; link = &(*link)->m_previous) {
+            Chunk* chunk{ *link };
+            if (chunk->m_size >= size) {
+                *link = chunk->m_previous;
+                return chunk;
+            }
+        }
+        return nullptr;
+    }
+
+    // the oldest released chunk ends up first in the spare list
+    void Arena::releaseChunks(Chunk* last)
+    {
+        while (m_chunks != last) {
+            Chunk* previous{ m_chunks->m_previous };
+            m_chunks->m_previous = m_spareChunks;
+            m_spareChunks = m_chunks;
+            m_chunks = previous;
+        }
+    }
+
+    // =================================================================================
+    // nested scopes: everything allocated within a scope is released at its end.
+    // Containers using the arena must be destroyed before - define them after the scope
+
+    class ArenaScope
+    {
+    private:
+        Arena& m_arena;
+        Arena::Marker m_marker;
+
+    public:
+        explicit ArenaScope(Arena& arena) : m_arena{ arena }, m_marker{ arena.mark() } {}
+        ~ArenaScope() { m_arena.rewind(m_marker); }
+
+        ArenaScope(const ArenaScope&) = delete;
+        ArenaScope& operator= (const ArenaScope&) = delete;
+    };
+
+    // =================================================================================
+    // same interface as 'MyAlloc' (AllocatorSimple.cpp), but bump allocation in an arena
+
+    template <typename T>
+    struct MyAlloc {
+
+        typedef T value_type;
+
+        explicit MyAlloc(Arena& arena) : m_arena{ &arena } {}
+
+        template <class TP>
+        MyAlloc(const MyAlloc<TP>& alloc) : m_arena{ alloc.m_arena } {}
+
+        T* allocate(size_t n);
+        void deallocate(T* p, size_t n);
+
+        Arena* m_arena;
+    };
+
+    template <class T>
+    T* MyAlloc<T>::allocate(size_t n) {
+        return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    // nothing to do until the scope ends
+    template <class T>
+    void MyAlloc<T>::deallocate(T*, size_t) {}
+
+    template <class T, class U>
+    bool operator==(const MyAlloc<T>& lhs, const MyAlloc<U>& rhs) {
+        return lhs.m_arena == rhs.m_arena;
+    }
+
+    template <class T, class U>
+    bool operator!=(const MyAlloc<T>& lhs, const MyAlloc<U>& rhs) {
+        return lhs.m_arena != rhs.m_arena;
+    }
+
+    // =================================================================================
+
+    constexpr int AnotherMax = 5;
+
+    void test_01_arena_allocator() {
+
+        std::cout << "Insertion: emplace_back into an arena" << std::endl;
+
+        std::array<std::byte, 256> buffer;
+        Arena arena{ buffer.data(), buffer.size() };
+
+        std::vector<Dummy, MyAlloc<Dummy>> vec{ MyAlloc<Dummy>{ arena } };
+        // vec.reserve(AnotherMax);   // put into comments ... or not
+        for (int n = 0; n < AnotherMax; ++n) {
+            vec.emplace_back(n);
+        }
+
+        std::cout << "chunks from upstream: " << arena.chunks() << std::endl;  // 0
+    }
+
+    void test_02_arena_allocator() {
+
+        Arena arena;
+
+        ArenaScope outer{ arena };
+        std::vector<int, MyAlloc<int>> numbers{ MyAlloc<int>{ arena } };
+        numbers.reserve(1000);
+
+        for (int request = 0; request < 3; ++request) {
+
+            // nested scope: memory of temporary containers is released in bulk
+            ArenaScope inner{ arena };
+            std::vector<std::string, MyAlloc<std::string>> words{ MyAlloc<std::string>{ arena } };
+            for (int n = 0; n < 1000; ++n) {
+                words.push_back("word");
+            }
+
+            numbers.push_back(static_cast<int>(words.size()));
+            std::cout << "request " << request << ": chunks = " << arena.chunks() << std::endl;
+        }
+
+        // the chunks of the inner scopes are kept as spare chunks
+        std::cout << "after requests: chunks = " << arena.chunks() << std::endl;
+    }
+
+    void test_03_arena_allocator() {
+
+        // interoperability with std::pmr
+        Arena arena;
+        {
+            std::pmr::vector<std::pmr::string> names{ &arena };
+            names.emplace_back("allocated in the arena, also the characters of this string");
+            std::cout << names.front() << std::endl;
+        }
+
+        // an arena without fallback
+        std::array<std::byte, 64> buffer;
+        Arena fixed{ buffer.data(), buffer.size(), nullptr };
+        try {
+            std::pmr::vector<int> numbers{ &fixed };
+            numbers.resize(100);
+        }
+        catch (const std::bad_alloc&) {
+            std::cout << "buffer exhausted, no upstream resource" << std::endl;
+        }
+
+        // an arena as upstream of another arena
+        Arena inner{ &arena };
+        std::pmr::vector<int> numbers{ &inner };
+        numbers.resize(100);
+        std::cout << "outer chunks: " << arena.chunks() << ", inner chunks: " << inner.chunks() << std::endl;
+    }
+
+    // =================================================================================
+    // benchmark: short-lived containers per 'request'
+
+    constexpr size_t Requests{ 1000 };
+    constexpr size_t ContainersPerRequest{ 20 };
+    constexpr int ElementsPerContainer{ 64 };
+
+    template <typename TVector, typename TMake>
+    size_t handleRequest(TMake&& make) {
+        size_t total{};
+        for (size_t i{}; i != ContainersPerRequest; ++i) {
+            TVector vec{ make() };
+            for (int n = 0; n < ElementsPerContainer; ++n) {
+                vec.push_back(n);
+            }
+            total += vec.size();
+        }
+        return total;
+    }
+
+    void test_04_arena_allocator_benchmark() {
+
+        std::cout << "Short-lived vectors (" << Requests << " requests, " << ContainersPerRequest
+            << " vectors each):" << std::endl;
+
+        Benchmarking::print(std::cout, "std::allocator", Benchmarking::measure([]() {
+            for (size_t request{}; request != Requests; ++request) {
+                Benchmarking::doNotOptimize(handleRequest<std::vector<int>>([]() { return std::vector<int>{}; }));
+            }
+        }));
+
+        Arena arena;
+        Benchmarking::print(std::cout, "Arena, scope per request", Benchmarking::measure([&]() {
+            for (size_t request{}; request != Requests; ++request) {
+                ArenaScope scope{ arena };
+                Benchmarking::doNotOptimize(handleRequest<std::vector<int, MyAlloc<int>>>(
+                    [&]() { return std::vector<int, MyAlloc<int>>{ MyAlloc<int>{ arena } }; }
+                ));
+            }
+        }));
+
+        Benchmarking::print(std::cout, "std::pmr::monotonic_buffer_resource", Benchmarking::measure([]() {
+            for (size_t request{}; request != Requests; ++request) {
+                std::pmr::monotonic_buffer_resource resource;
+                Benchmarking::doNotOptimize(handleRequest<std::pmr::vector<int>>(
+                    [&]() { return std::pmr::vector<int>{ &resource }; }
+                ));
+            }
+        }));
+    }
+}
+
+void main_allocator_arena()
+{
+    using namespace AllocatorArena;
+    test_01_arena_allocator();
+    test_02_arena_allocator();
+    test_03_arena_allocator();
+    test_04_arena_allocator_benchmark();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
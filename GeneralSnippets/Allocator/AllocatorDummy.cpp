@@ -96,6 +96,56 @@ namespace AllocatorWithObject {
             vec.emplace_back(n);
         }
     }
+
+    // =================================================================================
+    // the scenarios from above as regression checks:
+    // the numbers of copies and moves are checked instead of reading the output
+
+    void test_02_allocator_regression() {
+
+        RegressionCheck<Dummy> check{ "Allocator" };
+
+        {
+            CountingScope<Dummy> scope;
+            std::vector<Dummy> vec;
+            vec.reserve(AnotherMax);
+            for (int n = 0; n < AnotherMax; ++n) {
+                Dummy dummy(n);
+                vec.push_back(dummy);
+            }
+            check(expect_copies(scope.counts(), AnotherMax, "push_back - LValue, reserved"));
+        }
+
+        {
+            CountingScope<Dummy> scope;
+            std::vector<Dummy> vec;
+            vec.reserve(AnotherMax);
+            for (int n = 0; n < AnotherMax; ++n) {
+                vec.push_back(Dummy(n));
+            }
+            check(expect_copies_and_moves(scope.counts(), 0, AnotherMax, "push_back - RValue, reserved"));
+        }
+
+        {
+            CountingScope<Dummy> scope;
+            std::vector<Dummy> vec;
+            vec.reserve(AnotherMax);
+            for (int n = 0; n < AnotherMax; ++n) {
+                vec.emplace_back(n);
+            }
+            check(expect_in_place(scope.counts(), "emplace_back, reserved"));
+        }
+
+        {
+            // growing without 'reserve': the elements are moved - the move c'tor is 'noexcept'
+            CountingScope<Dummy> scope;
+            std::vector<Dummy> vec;
+            for (int n = 0; n < AnotherMax; ++n) {
+                vec.emplace_back(n);
+            }
+            check(expect_no_copies(scope.counts(), "emplace_back, growing"));
+        }
+    }
 }
 
 void main_allocator_classtype()
@@ -104,6 +154,7 @@ void main_allocator_classtype()
     test_01a_allocator();
     test_01b_allocator();
     test_01c_allocator();
+    test_02_allocator_regression();
 }
 
 // =====================================================================================
@@ -0,0 +1,317 @@
+// =====================================================================================
+// Allocator - Vector with Growth Policies, Capacity Hints and realloc
+// =====================================================================================
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../Global/Benchmark.h"
+#include "../Global/ProcessMemory.h"
+#include "../Global/GrowthVector.h"
+#include "../Global/CowBuffer.h"
+#include "../Global/Dummy.h"
+#include "../MoveSemantics/MoveSemantics.h"
+
+namespace AllocatorGrowthVector {
+
+    // capacity hints by tag, may be saved and loaded to survive the program run
+    class CapacityHints
+    {
+    private:
+        std::mutex m_mutex;
+        std::map<std::string, CapacityHint> m_hints;  // nodes never move
+
+    public:
+        static CapacityHints& instance();
+
+        CapacityHint& get(const std::string& tag);
+
+        // one line per tag: <capacity> <tag>
+        void write(std::ostream& os);
+        void read(std::istream& is);
+    };
+
+    CapacityHints& CapacityHints::instance()
+    {
+        static CapacityHints hints;
+        return hints;
+    }
+
+    CapacityHint& CapacityHints::get(const std::string& tag)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        return m_hints[tag];
+    }
+
+    void CapacityHints::write(std::ostream& os)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        for (const auto& [tag, hint] : m_hints) {
+            os << hint.capacity() << ' ' << tag << std::endl;
+        }
+    }
+
+    void CapacityHints::read(std::istream& is)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        size_t capacity{};
+        std::string tag;
+        while (is >> capacity && std::getline(is >> std::ws, tag)) {
+            m_hints[tag].record(capacity);
+        }
+    }
+
+    // =================================================================================
+
+    constexpr int Max = 50;
+
+    template <typename TVector>
+    void fill(const std::string& label, TVector& vec) {
+        for (int n = 0; n < Max; ++n) {
+            vec.push_back(n);
+        }
+        std::cout << std::left << std::setw(32) << label << std::right
+            << "capacity: " << std::setw(3) << vec.capacity()
+            << ", reallocations: " << vec.reallocations() << std::endl;
+    }
+
+    // growing to 50 elements as in 'test_02_allocator'
+    void test_01_growth_vector() {
+
+        GrowthVector<int, DoublingGrowth> doubling;
+        fill("DoublingGrowth", doubling);
+
+        GrowthVector<int, GoldenGrowth> golden;
+        fill("GoldenGrowth (1.5)", golden);
+
+        GrowthVector<int, LinearGrowth<8>> linear;
+        fill("LinearGrowth<8>", linear);
+
+        // the first container learns the size, the following ones reserve it
+        CapacityHint& hint{ CapacityHints::instance().get("test_01_growth_vector") };
+        for (int run = 1; run <= 3; ++run) {
+            GrowthVector<int> hinted{ hint };
+            fill("CapacityHint, run " + std::to_string(run), hinted);
+        }
+
+        // 'shrink_to_fit' as in 'StandardLibrarySTL::test_03': realloc shrinks in place
+        GrowthVector<int> vec;
+        vec.reserve(100);
+        for (int i = 0; i < 50; i++) {
+            vec.push_back(i);
+        }
+        const int* before{ vec.data() };
+        std::cout << "Size: " << vec.size() << ", Capacity: " << vec.capacity() << std::endl;
+        vec.shrink_to_fit();
+        std::cout << "Size: " << vec.size() << ", Capacity: " << vec.capacity()
+            << (vec.data() == before ? " (in place)" : " (moved)") << std::endl;
+
+        CapacityHints::instance().write(std::cout);
+    }
+
+    // elements with a non-trivial move c'tor: no realloc, moved one by one
+    void test_02_growth_vector() {
+
+        GrowthVector<std::string, GoldenGrowth> vec;
+        vec.push_back("C++");
+        vec.emplace_back(20, '*');
+
+        // the argument refers to an element of the full vector
+        while (vec.size() != vec.capacity()) {
+            vec.push_back("Growth");
+        }
+        vec.push_back(vec[0]);
+
+        GrowthVector<std::string, GoldenGrowth> copy{ vec };
+        GrowthVector<std::string, GoldenGrowth> moved{ std::move(vec) };
+
+        for (const std::string& s : copy) {
+            std::cout << s << ' ';
+        }
+        std::cout << std::endl;
+        std::cout << "copy: " << copy.size() << ", moved: " << moved.size() << ", source: " << vec.size() << std::endl;
+    }
+
+    // =================================================================================
+    // benchmark: push_back throughput and peak resident memory
+
+    template <typename TVector>
+    void pushBack(TVector& vec, size_t count) {
+        for (size_t i{}; i != count; ++i) {
+            vec.push_back(static_cast<int>(i));
+        }
+        Benchmarking::doNotOptimize(vec.data());
+    }
+
+    // growth of the high-water mark of the working set while 'function' runs
+    template <typename TFunction>
+    void peakMemory(const std::string& label, TFunction function) {
+
+        if (!ProcessMemory::resetPeak()) {
+            std::cout << std::left << std::setw(36) << label << std::right << "peak RSS not available" << std::endl;
+            return;
+        }
+
+        size_t before{ ProcessMemory::current().residentBytes };
+        function();
+        size_t peak{ ProcessMemory::current().peakResidentBytes };
+
+        std::cout << std::left << std::setw(36) << label << std::right
+            << "peak RSS: +" << std::setw(5) << (peak - before) / (1024 * 1024) << " MB" << std::endl;
+    }
+
+    void test_03_growth_vector_benchmark() {
+
+        Benchmarking::Benchmark benchmark{ "push_back of n ints" };
+
+        benchmark.add("std::vector", [](size_t size) -> Benchmarking::Benchmark::Function {
+            return [=]() { std::vector<int> vec; pushBack(vec, size); };
+        });
+
+        benchmark.add("GrowthVector, DoublingGrowth", [](size_t size) -> Benchmarking::Benchmark::Function {
+            return [=]() { GrowthVector<int, DoublingGrowth> vec; pushBack(vec, size); };
+        });
+
+        benchmark.add("GrowthVector, GoldenGrowth", [](size_t size) -> Benchmarking::Benchmark::Function {
+            return [=]() { GrowthVector<int, GoldenGrowth> vec; pushBack(vec, size); };
+        });
+
+        benchmark.add("GrowthVector, CapacityHint", [](size_t size) -> Benchmarking::Benchmark::Function {
+            CapacityHint* hint{ &CapacityHints::instance().get("benchmark " + std::to_string(size)) };
+            return [=]() { GrowthVector<int> vec{ *hint }; pushBack(vec, size); };
+        });
+
+        benchmark.run({ 1000, 100000, 10000000 });
+
+        // 256 MB of ints: old and new buffer are alive at the same time unless realloc grows in place,
+        // but only touched pages count - the new buffer is half empty while the elements are copied
+        constexpr size_t Elements{ 64 * 1024 * 1024 };
+
+        peakMemory("std::vector", []() { std::vector<int> vec; pushBack(vec, Elements); });
+        peakMemory("std::vector, reserve", []() { std::vector<int> vec; vec.reserve(Elements); pushBack(vec, Elements); });
+        peakMemory("GrowthVector, DoublingGrowth", []() { GrowthVector<int, DoublingGrowth> vec; pushBack(vec, Elements); });
+        peakMemory("GrowthVector, GoldenGrowth", []() { GrowthVector<int, GoldenGrowth> vec; pushBack(vec, Elements); });
+    }
+
+    // =================================================================================
+    // trivially relocatable elements: growth, insert and erase without move c'tor calls
+
+    using MoveSemantics::BigData;
+
+    void test_04_relocation() {
+
+        std::cout << std::boolalpha
+            << "BigData: " << is_trivially_relocatable_v<BigData>
+            << ", Dummy: " << is_trivially_relocatable_v<Dummy>
+            << ", std::string: " << is_trivially_relocatable_v<std::string> << std::endl;
+
+        GrowthVector<BigData> vec;
+        for (size_t n = 1; n <= 5; ++n) {
+            vec.emplace_back(n * 10, static_cast<int>(n));   // 10 elements inline, the others on the heap
+        }
+
+        vec.insert(vec.begin(), BigData(3, 0));
+        vec.erase(vec.begin() + 2);
+        vec.insert(vec.begin() + 1, vec.back());             // argument refers to an element
+
+        for (const BigData& data : vec) {
+            std::cout << data << std::endl;
+        }
+
+        // 'Dummy' is not trivially relocatable: growing and erasing
+        // call its move c'tor and d'tor element by element
+        CountingScope<Dummy> scope;
+        {
+            GrowthVector<Dummy> dummies;
+            dummies.emplace_back(1);
+            dummies.emplace_back(2);
+            dummies.emplace_back(3);
+            dummies.erase(dummies.begin());
+            std::cout << "dummies: " << dummies.size() << std::endl;
+        }
+        std::cout << "GrowthVector<Dummy>: " << scope.counts() << std::endl;
+    }
+
+    // 'push_back' of n elements, n insertions and erasures at the front of a vector with n elements
+    template <typename TVector, typename TFactory>
+    void addRelocationCases(Benchmarking::Benchmark& benchmark, const std::string& name, TFactory factory) {
+
+        benchmark.add(name + ", emplace_back", [=](size_t size) -> Benchmarking::Benchmark::Function {
+            return [=]() {
+                TVector vec;
+                for (size_t i{}; i != size; ++i) {
+                    factory(vec);
+                }
+                Benchmarking::doNotOptimize(vec.data());
+            };
+        });
+
+        benchmark.add(name + ", insert + erase at front", [=](size_t size) -> Benchmarking::Benchmark::Function {
+            auto vec{ std::make_shared<TVector>() };
+            for (size_t i{}; i != size; ++i) {
+                factory(*vec);
+            }
+            return [=]() {
+                for (size_t i{}; i != 100; ++i) {
+                    vec->insert(vec->begin(), vec->back());
+                    vec->erase(vec->begin());
+                }
+                Benchmarking::doNotOptimize(vec->data());
+            };
+        });
+    }
+
+    // plain trivially copyable type: std::vector relocates it with memmove, too
+    struct Record {
+        int m_id;
+        double m_value;
+    };
+
+    void test_05_relocation_benchmark() {
+
+        Benchmarking::Benchmark benchmark{ "std::vector vs. GrowthVector (memcpy relocation)" };
+
+        auto smallBigData = [](auto& vec) { vec.emplace_back(8, 1); };
+        auto largeBigData = [](auto& vec) { vec.emplace_back(100, 1); };
+        auto record = [](auto& vec) { vec.push_back(Record{ 1, 1.0 }); };
+
+        addRelocationCases<std::vector<BigData>>(benchmark, "std::vector<BigData(8)>", smallBigData);
+        addRelocationCases<GrowthVector<BigData>>(benchmark, "GrowthVector<BigData(8)>", smallBigData);
+        addRelocationCases<std::vector<BigData>>(benchmark, "std::vector<BigData(100)>", largeBigData);
+        addRelocationCases<GrowthVector<BigData>>(benchmark, "GrowthVector<BigData(100)>", largeBigData);
+        addRelocationCases<std::vector<Record>>(benchmark, "std::vector<Record>", record);
+        addRelocationCases<GrowthVector<Record>>(benchmark, "GrowthVector<Record>", record);
+
+        benchmark.run({ 1000, 100000 });
+    }
+}
+
+void main_allocator_growth_vector()
+{
+    using namespace AllocatorGrowthVector;
+    test_01_growth_vector();
+    test_02_growth_vector();
+    test_03_growth_vector_benchmark();
+    test_04_relocation();
+    test_05_relocation_benchmark();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -0,0 +1,369 @@
+// =====================================================================================
+// Allocator - Fixed-Size Pool Allocator
+// =====================================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <iostream>
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../Global/Benchmark.h"
+
+namespace AllocatorPool {
+
+    // fixed-block pool: one free list per size class, refilled in slabs.
+    // Node-based containers (std::list, std::map, std::unordered_map)
+    // allocate one node at a time - all nodes of a container have the same size
+    class BlockPool
+    {
+    public:
+        static constexpr size_t Alignment{ alignof(std::max_align_t) };
+        static constexpr size_t MaxBlockSize{ 256 };     // larger requests are forwarded to ::operator new
+        static constexpr size_t SizeClasses{ MaxBlockSize / Alignment };
+        static constexpr size_t SlabSize{ 64 * 1024 };
+
+    private:
+        struct FreeBlock {
+            FreeBlock* m_next;
+        };
+
+        std::array<FreeBlock*, SizeClasses> m_freeLists;
+        std::vector<void*> m_slabs;
+
+    public:
+        // c'tors and d'tor
+        BlockPool();
+        ~BlockPool();
+
+        // no copy semantics: allocators refer to their pool
+        BlockPool(const BlockPool&) = delete;
+        BlockPool& operator= (const BlockPool&) = delete;
+
+        void* allocate(size_t bytes, size_t alignment);
+        void deallocate(void* ptr, size_t bytes, size_t alignment) noexcept;
+
+        // getter
+        size_t slabs() const { return m_slabs.size(); }
+
+        static bool isPooled(size_t bytes, size_t alignment) {
+            return bytes != 0 && bytes <= MaxBlockSize && alignment <= Alignment;
+        }
+
+    private:
+        static size_t sizeClass(size_t bytes) { return (bytes + Alignment - 1) / Alignment - 1; }
+        static size_t blockSize(size_t sizeClass) { return (sizeClass + 1) * Alignment; }
+
+        void refill(size_t sizeClass);
+
+        // requests not served by the pool, honoring over-aligned types
+        static void* allocateUnpooled(size_t bytes, size_t alignment);
+        static void deallocateUnpooled(void* ptr, size_t alignment) noexcept;
+    };
+
+    BlockPool::BlockPool() : m_freeLists{} {}
+
+    BlockPool::~BlockPool()
+    {
+        for (void* slab : m_slabs) {
+            ::operator delete(slab);
+        }
+    }
+
+    void* BlockPool::allocate(size_t bytes, size_t alignment)
+    {
+        if (!isPooled(bytes, alignment)) {
+            return allocateUnpooled(bytes, alignment);
+        }
+
+        size_t index{ sizeClass(bytes) };
+        if (m_freeLists[index] == nullptr) {
+            refill(index);
+        }
+
+        FreeBlock* block{ m_freeLists[index] };
+        m_freeLists[index] = block->m_next;
+        return block;
+    }
+
+    void BlockPool::deallocate(void* ptr, size_t bytes, size_t alignment) noexcept
+    {
+        if (!isPooled(bytes, alignment)) {
+            deallocateUnpooled(ptr, alignment);
+            return;
+        }
+
+        size_t index{ sizeClass(bytes) };
+        FreeBlock* block{ static_cast<FreeBlock*>(ptr) };
+        block->m_next = m_freeLists[index];
+        m_freeLists[index] = block;
+    }
+
+    void* BlockPool::allocateUnpooled(size_t bytes, size_t alignment)
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return ::operator new(bytes, std::align_val_t{ alignment });
+        }
+        return ::operator new(bytes);
+    }
+
+    void BlockPool::deallocateUnpooled(void* ptr, size_t alignment) noexcept
+    {
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(ptr, std::align_val_t{ alignment });
+            return;
+        }
+        ::operator delete(ptr);
+    }
+
+    // a new slab is cut into blocks of one size class, linked in address order
+    void BlockPool::refill(size_t sizeClass)
+    {
+        m_slabs.reserve(m_slabs.size() + 1);  // no leak if push_back throws
+
+        char* slab{ static_cast<char*>(::operator new(SlabSize)) };
+        m_slabs.push_back(slab);
+
+        size_t size{ blockSize(sizeClass) };
+        size_t count{ SlabSize / size };
+
+        FreeBlock* head{ m_freeLists[sizeClass] };
+        for (size_t i{ count }; i != 0; --i) {
+            FreeBlock* block{ reinterpret_cast<FreeBlock*>(slab + (i - 1) * size) };
+            block->m_next = head;
+            head = block;
+        }
+        m_freeLists[sizeClass] = head;
+    }
+
+    // =================================================================================
+    // C++11 allocator on top of a 'BlockPool' - no output, meets the Allocator requirements
+
+    template <typename T>
+    class PoolAlloc
+    {
+    private:
+        BlockPool* m_pool;
+
+        template <typename U>
+        friend class PoolAlloc;
+
+    public:
+        using value_type = T;
+
+        // the pool outlives every container using it, so allocators may travel with the elements
+        using propagate_on_container_copy_assignment = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        explicit PoolAlloc(BlockPool& pool) noexcept : m_pool{ &pool } {}
+
+        // rebind: a std::list<T> allocates its nodes with a PoolAlloc<Node<T>>
+        template <typename U>
+        PoolAlloc(const PoolAlloc<U>& other) noexcept : m_pool{ other.m_pool } {}
+
+        T* allocate(size_t n);
+        void deallocate(T* p, size_t n) noexcept;
+
+        template <typename U>
+        bool operator== (const PoolAlloc<U>& other) const noexcept { return m_pool == other.m_pool; }
+
+        template <typename U>
+        bool operator!= (const PoolAlloc<U>& other) const noexcept { return m_pool != other.m_pool; }
+    };
+
+    template <typename T>
+    T* PoolAlloc<T>::allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length{};
+        }
+        return static_cast<T*>(m_pool->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    template <typename T>
+    void PoolAlloc<T>::deallocate(T* p, size_t n) noexcept {
+        m_pool->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    // =================================================================================
+
+    void test_01_pool_allocator() {
+
+        BlockPool pool;
+
+        std::list<int, PoolAlloc<int>> list{ PoolAlloc<int>{ pool } };
+        for (int n = 0; n < 10; ++n) {
+            list.push_back(n);
+        }
+
+        std::map<int, std::string, std::less<int>, PoolAlloc<std::pair<const int, std::string>>> map{
+            PoolAlloc<std::pair<const int, std::string>>{ pool }
+        };
+        map[1] = "one";
+        map[2] = "two";
+        map[3] = "three";
+
+        // the bucket array is larger than a block and comes from ::operator new
+        std::unordered_map<std::string, int, std::hash<std::string>, std::equal_to<std::string>,
+            PoolAlloc<std::pair<const std::string, int>>> unorderedMap{
+                16, std::hash<std::string>{}, std::equal_to<std::string>{},
+                PoolAlloc<std::pair<const std::string, int>>{ pool }
+        };
+        unorderedMap["one"] = 1;
+        unorderedMap["two"] = 2;
+
+        // erased nodes go back to the free lists and are reused
+        list.erase(std::begin(list), std::next(std::begin(list), 5));
+        for (int n = 10; n < 15; ++n) {
+            list.push_back(n);
+        }
+
+        std::cout << "list:          ";
+        for (int n : list) {
+            std::cout << n << ' ';
+        }
+        std::cout << std::endl;
+
+        std::cout << "map:           ";
+        for (const auto& [key, value] : map) {
+            std::cout << key << '=' << value << ' ';
+        }
+        std::cout << std::endl;
+
+        std::cout << "unordered_map: " << unorderedMap.size() << " entries" << std::endl;
+
+        // over-aligned nodes bypass the pool, but keep their alignment
+        struct alignas(64) CacheLine { int m_value; };
+        std::list<CacheLine, PoolAlloc<CacheLine>> lines{ PoolAlloc<CacheLine>{ pool } };
+        lines.push_back(CacheLine{ 1 });
+        bool aligned{ reinterpret_cast<std::uintptr_t>(&lines.front()) % alignof(CacheLine) == 0 };
+        std::cout << "alignas(64):   " << std::boolalpha << aligned << std::endl;
+
+        // one slab per size class: the containers use different node sizes
+        std::cout << "slabs: " << pool.slabs() << std::endl;
+    }
+
+    // =================================================================================
+    // benchmark: insert/erase churn of node-based containers
+
+    template <typename TContainer>
+    void churnList(TContainer& list, size_t operations) {
+        for (size_t i{}; i != operations; ++i) {
+            list.pop_front();
+            list.push_back(static_cast<int>(i));
+        }
+    }
+
+    template <typename TContainer>
+    void churnMap(TContainer& map, const std::vector<int>& keys, size_t operations) {
+        // erase an existing key, insert a new one
+        size_t size{ map.size() };
+        for (size_t i{}; i != operations; ++i) {
+            map.erase(keys[i % keys.size()]);
+            map.emplace(keys[(i + size) % keys.size()], static_cast<int>(i));
+        }
+    }
+
+    // the pool must outlive the container: members are destroyed in reverse order
+    template <typename TContainer>
+    struct PooledContainer {
+        BlockPool m_pool;
+        TContainer m_container;
+
+        template <typename... TArgs>
+        explicit PooledContainer(TArgs&&... args)
+            : m_pool{}, m_container{ std::forward<TArgs>(args)..., typename TContainer::allocator_type{ m_pool } } {}
+    };
+
+    constexpr size_t ChurnOperations{ 100000 };
+
+    void test_02_pool_allocator_benchmark() {
+
+        Benchmarking::Benchmark benchmark{ "Node container churn: std::allocator vs. PoolAlloc" };
+
+        // shuffled keys, the container holds 'size' of them at any time
+        auto makeKeys = [](size_t size) {
+            std::vector<int> keys(2 * size);
+            for (size_t i{}; i != keys.size(); ++i) {
+                keys[i] = static_cast<int>(i);
+            }
+            std::shuffle(std::begin(keys), std::end(keys), std::mt19937{ 42 });
+            return keys;
+        };
+
+        benchmark.add("std::list, std::allocator", [](size_t size) -> Benchmarking::Benchmark::Function {
+            auto list{ std::make_shared<std::list<int>>(size, 0) };
+            return [=]() { churnList(*list, ChurnOperations); };
+        });
+
+        benchmark.add("std::list, PoolAlloc", [](size_t size) -> Benchmarking::Benchmark::Function {
+            auto list{ std::make_shared<PooledContainer<std::list<int, PoolAlloc<int>>>>(size, 0) };
+            return [=]() { churnList(list->m_container, ChurnOperations); };
+        });
+
+        benchmark.add("std::map, std::allocator", [&](size_t size) -> Benchmarking::Benchmark::Function {
+            auto keys{ std::make_shared<std::vector<int>>(makeKeys(size)) };
+            auto map{ std::make_shared<std::map<int, int>>() };
+            for (size_t i{}; i != size; ++i) {
+                map->emplace((*keys)[i], 0);
+            }
+            return [=]() { churnMap(*map, *keys, ChurnOperations); };
+        });
+
+        using PoolMap = std::map<int, int, std::less<int>, PoolAlloc<std::pair<const int, int>>>;
+
+        benchmark.add("std::map, PoolAlloc", [&](size_t size) -> Benchmarking::Benchmark::Function {
+            auto keys{ std::make_shared<std::vector<int>>(makeKeys(size)) };
+            auto map{ std::make_shared<PooledContainer<PoolMap>>() };
+            for (size_t i{}; i != size; ++i) {
+                map->m_container.emplace((*keys)[i], 0);
+            }
+            return [=]() { churnMap(map->m_container, *keys, ChurnOperations); };
+        });
+
+        benchmark.add("std::unordered_map, std::allocator", [&](size_t size) -> Benchmarking::Benchmark::Function {
+            auto keys{ std::make_shared<std::vector<int>>(makeKeys(size)) };
+            auto map{ std::make_shared<std::unordered_map<int, int>>() };
+            for (size_t i{}; i != size; ++i) {
+                map->emplace((*keys)[i], 0);
+            }
+            return [=]() { churnMap(*map, *keys, ChurnOperations); };
+        });
+
+        using PoolUnorderedMap = std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+            PoolAlloc<std::pair<const int, int>>>;
+
+        benchmark.add("std::unordered_map, PoolAlloc", [&](size_t size) -> Benchmarking::Benchmark::Function {
+            auto keys{ std::make_shared<std::vector<int>>(makeKeys(size)) };
+            auto map{ std::make_shared<PooledContainer<PoolUnorderedMap>>(size_t{}, std::hash<int>{}, std::equal_to<int>{}) };
+            for (size_t i{}; i != size; ++i) {
+                map->m_container.emplace((*keys)[i], 0);
+            }
+            return [=]() { churnMap(map->m_container, *keys, ChurnOperations); };
+        });
+
+        benchmark.run({ 1000, 100000 });
+    }
+}
+
+void main_allocator_pool()
+{
+    using namespace AllocatorPool;
+    test_01_pool_allocator();
+    test_02_pool_allocator_benchmark();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
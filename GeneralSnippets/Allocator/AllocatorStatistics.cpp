@@ -0,0 +1,475 @@
+// =====================================================================================
+// Allocator - Statistics Collecting Allocator Adaptor
+// =====================================================================================
+
+#include <cstddef>
+#include <new>
+#include <iostream>
+#include <iomanip>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../Global/Benchmark.h"
+
+namespace AllocatorStatistics {
+
+    // default of 'StatisticsAlloc': collecting in Debug builds, only forwarding to the
+    // wrapped allocator in Release builds ('NDEBUG'). The macro 'STATISTICS_ALLOCATOR'
+    // overrides the build configuration, e.g. /D STATISTICS_ALLOCATOR=1
+#if defined(STATISTICS_ALLOCATOR)
+    constexpr bool CollectStatistics = STATISTICS_ALLOCATOR != 0;
+#elif defined(NDEBUG)
+    constexpr bool CollectStatistics = false;
+#else
+    constexpr bool CollectStatistics = true;
+#endif
+
+    constexpr size_t HistogramBuckets = 40;   // bucket 'i' counts sizes in [2^i, 2^(i+1))
+
+    // counters of one snapshot
+    struct Snapshot {
+        std::string tag;
+        size_t containers;
+        size_t allocations;
+        size_t deallocations;
+        size_t bytesAllocated;
+        size_t bytesLive;
+        size_t peakBytesLive;
+        std::array<size_t, HistogramBuckets> histogram;
+    };
+
+    // =================================================================================
+    // counters of one tag (call site): relaxed atomics, every counter on its own is exact,
+    // a snapshot taken while other threads allocate is not necessarily consistent
+
+    class AllocationStatistics
+    {
+    private:
+        std::string m_tag;
+        std::atomic<size_t> m_containers;
+        std::atomic<size_t> m_allocations;
+        std::atomic<size_t> m_deallocations;
+        std::atomic<size_t> m_bytesAllocated;
+        std::atomic<size_t> m_bytesLive;
+        std::atomic<size_t> m_peakBytesLive;
+        std::array<std::atomic<size_t>, HistogramBuckets> m_histogram;
+
+    public:
+        explicit AllocationStatistics(const std::string& tag);
+
+        AllocationStatistics(const AllocationStatistics&) = delete;
+        AllocationStatistics& operator= (const AllocationStatistics&) = delete;
+
+        void recordContainer();
+        void recordAllocation(size_t bytes);
+        void recordDeallocation(size_t bytes);
+
+        void reset();
+        Snapshot snapshot() const;
+
+        // getter
+        const std::string& tag() const { return m_tag; }
+
+    private:
+        static size_t bucket(size_t bytes);
+    };
+
+    AllocationStatistics::AllocationStatistics(const std::string& tag)
+        : m_tag{ tag }, m_containers{}, m_allocations{}, m_deallocations{},
+          m_bytesAllocated{}, m_bytesLive{}, m_peakBytesLive{}, m_histogram{} {}
+
+    void AllocationStatistics::recordContainer()
+    {
+        m_containers.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void AllocationStatistics::recordAllocation(size_t bytes)
+    {
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        m_bytesAllocated.fetch_add(bytes, std::memory_order_relaxed);
+        m_histogram[bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+
+        size_t live{ m_bytesLive.fetch_add(bytes, std::memory_order_relaxed) + bytes };
+        size_t peak{ m_peakBytesLive.load(std::memory_order_relaxed) };
+        while (live > peak && !m_peakBytesLive.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void AllocationStatistics::recordDeallocation(size_t bytes)
+    {
+        m_deallocations.fetch_add(1, std::memory_order_relaxed);
+        m_bytesLive.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    void AllocationStatistics::reset()
+    {
+        m_containers.store(0, std::memory_order_relaxed);
+        m_allocations.store(0, std::memory_order_relaxed);
+        m_deallocations.store(0, std::memory_order_relaxed);
+        m_bytesAllocated.store(0, std::memory_order_relaxed);
+        m_peakBytesLive.store(m_bytesLive.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for (auto& count : m_histogram) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    Snapshot AllocationStatistics::snapshot() const
+    {
+        Snapshot snapshot{};
+        snapshot.tag = m_tag;
+        snapshot.containers = m_containers.load(std::memory_order_relaxed);
+        snapshot.allocations = m_allocations.load(std::memory_order_relaxed);
+        snapshot.deallocations = m_deallocations.load(std::memory_order_relaxed);
+        snapshot.bytesAllocated = m_bytesAllocated.load(std::memory_order_relaxed);
+        snapshot.bytesLive = m_bytesLive.load(std::memory_order_relaxed);
+        snapshot.peakBytesLive = m_peakBytesLive.load(std::memory_order_relaxed);
+        for (size_t i{}; i != HistogramBuckets; ++i) {
+            snapshot.histogram[i] = m_histogram[i].load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    size_t AllocationStatistics::bucket(size_t bytes)
+    {
+        size_t index{};
+        while (bytes > 1 && index + 1 != HistogramBuckets) {
+            bytes >>= 1;
+            ++index;
+        }
+        return index;
+    }
+
+    // =================================================================================
+    // one 'AllocationStatistics' object per tag, never moved or destroyed
+
+    class StatisticsRegistry
+    {
+    private:
+        std::mutex m_mutex;
+        std::deque<AllocationStatistics> m_statistics;
+
+    public:
+        static StatisticsRegistry& instance();
+
+        // looked up once per container, not once per allocation
+        AllocationStatistics& get(const std::string& tag);
+
+        std::vector<Snapshot> snapshots();
+    };
+
+    StatisticsRegistry& StatisticsRegistry::instance()
+    {
+        static StatisticsRegistry registry;
+        return registry;
+    }
+
+    AllocationStatistics& StatisticsRegistry::get(const std::string& tag)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        for (AllocationStatistics& statistics : m_statistics) {
+            if (statistics.tag() == tag) {
+                return statistics;
+            }
+        }
+        return m_statistics.emplace_back(tag);
+    }
+
+    std::vector<Snapshot> StatisticsRegistry::snapshots()
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        std::vector<Snapshot> result;
+        for (const AllocationStatistics& statistics : m_statistics) {
+            result.push_back(statistics.snapshot());
+        }
+        return result;
+    }
+
+    inline AllocationStatistics& statistics(const std::string& tag)
+    {
+        return StatisticsRegistry::instance().get(tag);
+    }
+
+    // =================================================================================
+    // JSON export: 'allocations_per_container' reveals reallocation storms, a std::vector
+    // growing to n elements without 'reserve' needs about log2(n) allocations instead of 1
+    // (node-based containers allocate one node per element anyway).
+    // 'allocated_to_peak' is 1 if every byte was allocated once; the peak includes the
+    // old and the new buffer of a growth step, so doubling growth only reaches about 4/3
+
+    static std::string quoted(const std::string& text)
+    {
+        std::string result{ "\"" };
+        for (char ch : text) {
+            if (ch == '"' || ch == '\\') {
+                result += '\\';
+            }
+            result += ch;
+        }
+        result += '"';
+        return result;
+    }
+
+    void writeJson(std::ostream& os, const std::vector<Snapshot>& snapshots)
+    {
+        os << "[" << std::endl;
+
+        for (size_t i{}; i != snapshots.size(); ++i) {
+            const Snapshot& snapshot{ snapshots[i] };
+
+            double perContainer{ snapshot.containers != 0
+                ? static_cast<double>(snapshot.allocations) / snapshot.containers
+                : 0.0 };
+
+            double ratio{ snapshot.peakBytesLive != 0
+                ? static_cast<double>(snapshot.bytesAllocated) / snapshot.peakBytesLive
+                : 0.0 };
+
+            os << "  { "
+                << "\"tag\": " << quoted(snapshot.tag) << ", "
+                << "\"containers\": " << snapshot.containers << ", "
+                << "\"allocations\": " << snapshot.allocations << ", "
+                << "\"allocations_per_container\": " << perContainer << ", "
+                << "\"deallocations\": " << snapshot.deallocations << ", "
+                << "\"bytes_allocated\": " << snapshot.bytesAllocated << ", "
+                << "\"bytes_live\": " << snapshot.bytesLive << ", "
+                << "\"peak_bytes_live\": " << snapshot.peakBytesLive << ", "
+                << "\"allocated_to_peak\": " << ratio << ", "
+                << "\"histogram\": {";
+
+            // only used buckets, named by their lower bound
+            bool first{ true };
+            for (size_t bucket{}; bucket != HistogramBuckets; ++bucket) {
+                if (snapshot.histogram[bucket] != 0) {
+                    os << (first ? " " : ", ") << '"' << (size_t{ 1 } << bucket) << "\": " << snapshot.histogram[bucket];
+                    first = false;
+                }
+            }
+
+            os << (first ? "" : " ") << "} }" << (i + 1 != snapshots.size() ? "," : "") << std::endl;
+        }
+
+        os << "]" << std::endl;
+    }
+
+    // =================================================================================
+    // allocator adaptor: wraps any allocator, e.g. std::allocator<T> or 'MyAlloc<T>'.
+    // 'Enabled == false': every call is forwarded only, the statistics stay unchanged
+
+    template <typename T, typename TAllocator = std::allocator<T>, bool Enabled = CollectStatistics>
+    class StatisticsAlloc
+    {
+    private:
+        using Upstream = typename std::allocator_traits<TAllocator>::template rebind_alloc<T>;
+
+        Upstream m_upstream;
+        AllocationStatistics* m_statistics;
+
+        template <typename U, typename UAllocator, bool UEnabled>
+        friend class StatisticsAlloc;
+
+    public:
+        using value_type = T;
+
+        template <typename U>
+        struct rebind {
+            using other = StatisticsAlloc<U, typename std::allocator_traits<TAllocator>::template rebind_alloc<U>, Enabled>;
+        };
+
+        // one call per container: copies and rebound adaptors are not counted
+        explicit StatisticsAlloc(AllocationStatistics& statistics, const TAllocator& upstream = TAllocator{})
+            : m_upstream{ upstream }, m_statistics{ &statistics }
+        {
+            if constexpr (Enabled) {
+                m_statistics->recordContainer();
+            }
+        }
+
+        template <typename U, typename UAllocator>
+        StatisticsAlloc(const StatisticsAlloc<U, UAllocator, Enabled>& other)
+            : m_upstream{ other.m_upstream }, m_statistics{ other.m_statistics } {}
+
+        T* allocate(size_t n);
+        void deallocate(T* p, size_t n);
+
+        const AllocationStatistics& statistics() const { return *m_statistics; }
+
+        template <typename U, typename UAllocator>
+        bool operator== (const StatisticsAlloc<U, UAllocator, Enabled>& other) const {
+            return m_statistics == other.m_statistics && m_upstream == other.m_upstream;
+        }
+
+        template <typename U, typename UAllocator>
+        bool operator!= (const StatisticsAlloc<U, UAllocator, Enabled>& other) const {
+            return !(*this == other);
+        }
+    };
+
+    template <typename T, typename TAllocator, bool Enabled>
+    T* StatisticsAlloc<T, TAllocator, Enabled>::allocate(size_t n) {
+        T* ptr{ std::allocator_traits<Upstream>::allocate(m_upstream, n) };
+        if constexpr (Enabled) {
+            m_statistics->recordAllocation(n * sizeof(T));
+        }
+        return ptr;
+    }
+
+    template <typename T, typename TAllocator, bool Enabled>
+    void StatisticsAlloc<T, TAllocator, Enabled>::deallocate(T* p, size_t n) {
+        if constexpr (Enabled) {
+            m_statistics->recordDeallocation(n * sizeof(T));
+        }
+        std::allocator_traits<Upstream>::deallocate(m_upstream, p, n);
+    }
+
+    // =================================================================================
+
+    constexpr int Max = 50;
+
+    // 'test_02_allocator' without console output: with and without 'reserve'
+    void test_01_statistics_allocator() {
+
+        if constexpr (!CollectStatistics) {
+            std::cout << "Statistics are disabled in this build (NDEBUG), define STATISTICS_ALLOCATOR=1" << std::endl;
+        }
+
+        {
+            std::vector<int, StatisticsAlloc<int>> vec{ StatisticsAlloc<int>{ statistics("vector<int>, push_back") } };
+            for (int n = 0; n < Max; ++n) {
+                vec.push_back(n);
+            }
+        }
+
+        {
+            std::vector<int, StatisticsAlloc<int>> vec{ StatisticsAlloc<int>{ statistics("vector<int>, reserve + push_back") } };
+            vec.reserve(Max);
+            for (int n = 0; n < Max; ++n) {
+                vec.push_back(n);
+            }
+        }
+
+        // node-based containers: the adaptor is rebound to the node type
+        {
+            using Pair = std::pair<const int, std::string>;
+            std::map<int, std::string, std::less<int>, StatisticsAlloc<Pair>> map{ StatisticsAlloc<Pair>{ statistics("map<int, string>") } };
+            for (int n = 0; n < Max; ++n) {
+                map[n] = std::to_string(n);
+            }
+        }
+
+        writeJson(std::cout, StatisticsRegistry::instance().snapshots());
+    }
+
+    // several threads, one tag
+    void test_02_statistics_allocator() {
+
+        AllocationStatistics& shared{ statistics("list<int>, 4 threads") };
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&]() {
+                std::list<int, StatisticsAlloc<int>> list{ StatisticsAlloc<int>{ shared } };
+                for (int n = 0; n < 10000; ++n) {
+                    list.push_back(n);
+                }
+            });
+        }
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        Snapshot snapshot{ shared.snapshot() };
+        std::cout << "allocations: " << snapshot.allocations           // 40000
+            << ", deallocations: " << snapshot.deallocations            // 40000
+            << ", live: " << snapshot.bytesLive << std::endl;           // 0
+    }
+
+    // overhead compared with the plain std::allocator: enabled and disabled adaptor,
+    // independent of the build configuration. Note: GCC's std::vector relocates its
+    // elements with memmove only for std::allocator itself, with every other allocator
+    // - even a forwarding one - element by element
+    template <typename T>
+    using CollectingAlloc = StatisticsAlloc<T, std::allocator<T>, true>;
+
+    template <typename T>
+    using ForwardingAlloc = StatisticsAlloc<T, std::allocator<T>, false>;
+
+    void test_03_statistics_allocator_benchmark() {
+
+        constexpr int Elements = 100000;
+
+        std::cout << "Overhead of StatisticsAlloc (" << Elements << " elements):" << std::endl;
+
+        Benchmarking::print(std::cout, "std::list, std::allocator", Benchmarking::measure([]() {
+            std::list<int> list;
+            for (int n = 0; n < Elements; ++n) {
+                list.push_back(n);
+            }
+            Benchmarking::doNotOptimize(list);
+        }));
+
+        AllocationStatistics& listStatistics{ statistics("benchmark: list<int>") };
+        Benchmarking::print(std::cout, "std::list, StatisticsAlloc (enabled)", Benchmarking::measure([&]() {
+            std::list<int, CollectingAlloc<int>> list{ CollectingAlloc<int>{ listStatistics } };
+            for (int n = 0; n < Elements; ++n) {
+                list.push_back(n);
+            }
+            Benchmarking::doNotOptimize(list);
+        }));
+
+        Benchmarking::print(std::cout, "std::list, StatisticsAlloc (disabled)", Benchmarking::measure([&]() {
+            std::list<int, ForwardingAlloc<int>> list{ ForwardingAlloc<int>{ listStatistics } };
+            for (int n = 0; n < Elements; ++n) {
+                list.push_back(n);
+            }
+            Benchmarking::doNotOptimize(list);
+        }));
+
+        Benchmarking::print(std::cout, "std::vector, std::allocator", Benchmarking::measure([]() {
+            std::vector<int> vec;
+            for (int n = 0; n < Elements; ++n) {
+                vec.push_back(n);
+            }
+            Benchmarking::doNotOptimize(vec);
+        }));
+
+        AllocationStatistics& vectorStatistics{ statistics("benchmark: vector<int>") };
+        Benchmarking::print(std::cout, "std::vector, StatisticsAlloc (enabled)", Benchmarking::measure([&]() {
+            std::vector<int, CollectingAlloc<int>> vec{ CollectingAlloc<int>{ vectorStatistics } };
+            for (int n = 0; n < Elements; ++n) {
+                vec.push_back(n);
+            }
+            Benchmarking::doNotOptimize(vec);
+        }));
+
+        Benchmarking::print(std::cout, "std::vector, StatisticsAlloc (disabled)", Benchmarking::measure([&]() {
+            std::vector<int, ForwardingAlloc<int>> vec{ ForwardingAlloc<int>{ vectorStatistics } };
+            for (int n = 0; n < Elements; ++n) {
+                vec.push_back(n);
+            }
+            Benchmarking::doNotOptimize(vec);
+        }));
+    }
+}
+
+void main_allocator_statistics()
+{
+    using namespace AllocatorStatistics;
+    test_01_statistics_allocator();
+    test_02_statistics_allocator();
+    test_03_statistics_allocator_benchmark();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
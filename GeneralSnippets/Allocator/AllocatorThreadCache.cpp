@@ -0,0 +1,637 @@
+// =====================================================================================
+// Allocator - Thread-Caching Allocator
+// =====================================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace AllocatorThreadCache {
+
+    // =================================================================================
+    // every thread allocates from its own cache without any lock.
+    // Blocks of one size class are carved from slabs; a slab belongs to the cache
+    // that created it. Free blocks are exchanged with a global depot in
+    // 'magazines' (chains of 'MagazineSize' blocks), one lock per magazine
+    // instead of one lock per block. A block freed by another thread is pushed
+    // lock-free onto the remote list of its owning cache
+
+    constexpr size_t Alignment{ alignof(std::max_align_t) };
+    constexpr size_t MaxBlockSize{ 256 };             // larger requests go to ::operator new
+    constexpr size_t SizeClasses{ MaxBlockSize / Alignment };
+    constexpr size_t SlabSize{ 64 * 1024 };           // slabs are aligned to their size
+    constexpr size_t MagazineSize{ 64 };
+
+    struct FreeBlock {
+        FreeBlock* m_next;
+    };
+
+    class ThreadCache;
+
+    // first bytes of every slab: a block finds its slab by masking its address
+    struct alignas(Alignment) SlabHeader {
+        ThreadCache* m_owner;
+        size_t m_sizeClass;
+    };
+
+    inline size_t sizeClass(size_t bytes) { return (bytes + Alignment - 1) / Alignment - 1; }
+    inline size_t blockSize(size_t sizeClass) { return (sizeClass + 1) * Alignment; }
+
+    inline SlabHeader* slabOf(void* block) {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<std::uintptr_t>(block) & ~(SlabSize - 1));
+    }
+
+    // =================================================================================
+
+    class ThreadCache
+    {
+    private:
+        struct LocalList {
+            FreeBlock* m_head;
+            size_t m_count;
+        };
+
+        std::array<LocalList, SizeClasses> m_local;                  // owner thread only
+        std::array<std::atomic<FreeBlock*>, SizeClasses> m_remote;   // pushed by other threads
+
+    public:
+        ThreadCache();
+
+        void* allocate(size_t sizeClass);
+        void deallocate(void* block, size_t sizeClass);
+
+        // called by other threads - lock-free
+        void pushRemote(void* block, size_t sizeClass);
+
+        // thread exit: all free blocks go to the depot
+        void flush();
+
+    private:
+        void refill(size_t sizeClass);
+        void pushLocal(FreeBlock* block, size_t sizeClass);
+    };
+
+    // =================================================================================
+
+    class ThreadCachingHeap
+    {
+    private:
+        std::mutex m_mutex;
+        std::array<std::vector<FreeBlock*>, SizeClasses> m_depot;  // full magazines
+        std::vector<std::unique_ptr<ThreadCache>> m_caches;        // never destroyed before the heap
+        std::vector<ThreadCache*> m_abandonedCaches;               // of finished threads, ready for adoption
+        std::vector<void*> m_slabs;
+
+    public:
+        ThreadCachingHeap() = default;
+        ~ThreadCachingHeap();
+
+        ThreadCachingHeap(const ThreadCachingHeap&) = delete;
+        ThreadCachingHeap& operator= (const ThreadCachingHeap&) = delete;
+
+        static ThreadCachingHeap& instance();
+
+        static void* allocate(size_t bytes);
+        static void deallocate(void* ptr, size_t bytes) noexcept;
+
+        // caches: a new thread adopts the cache of a finished thread, if any
+        ThreadCache* acquireCache();
+        void releaseCache(ThreadCache* cache);
+
+        // depot
+        FreeBlock* takeMagazine(size_t sizeClass);
+        void putMagazine(FreeBlock* magazine, size_t sizeClass);
+
+        // returns the first block of a new slab, the others are linked behind it
+        FreeBlock* newSlab(ThreadCache* owner, size_t sizeClass);
+
+        // getter
+        size_t slabs();
+        size_t magazines();
+    };
+
+    // the cache of the calling thread, handed back to the heap at thread exit
+    class ThreadCacheHandle
+    {
+    private:
+        ThreadCache* m_cache;
+
+    public:
+        ThreadCacheHandle() : m_cache{ ThreadCachingHeap::instance().acquireCache() } {}
+        ~ThreadCacheHandle() { ThreadCachingHeap::instance().releaseCache(m_cache); }
+
+        ThreadCache* get() const { return m_cache; }
+    };
+
+    inline ThreadCache* currentCache()
+    {
+        static thread_local ThreadCacheHandle t_handle;
+        return t_handle.get();
+    }
+
+    // =================================================================================
+
+    ThreadCache::ThreadCache() : m_local{}
+    {
+        for (auto& remote : m_remote) {
+            remote.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    void* ThreadCache::allocate(size_t sizeClass)
+    {
+        LocalList& list{ m_local[sizeClass] };
+        if (list.m_head == nullptr) {
+            refill(sizeClass);
+        }
+
+        FreeBlock* block{ list.m_head };
+        list.m_head = block->m_next;
+        --list.m_count;
+        return block;
+    }
+
+    void ThreadCache::deallocate(void* block, size_t sizeClass)
+    {
+        SlabHeader* slab{ slabOf(block) };
+        if (slab->m_owner != this) {
+            slab->m_owner->pushRemote(block, sizeClass);
+            return;
+        }
+
+        pushLocal(static_cast<FreeBlock*>(block), sizeClass);
+
+        // too many free blocks: one magazine goes to the depot for other threads
+        LocalList& list{ m_local[sizeClass] };
+        if (list.m_count >= 2 * MagazineSize) {
+            FreeBlock* magazine{ list.m_head };
+            FreeBlock* last{ magazine };
+            for (size_t i{ 1 }; i != MagazineSize; ++i) {
+                last = last->m_next;
+            }
+            list.m_head = last->m_next;
+            list.m_count -= MagazineSize;
+            last->m_next = nullptr;
+
+            ThreadCachingHeap::instance().putMagazine(magazine, sizeClass);
+        }
+    }
+
+    // Treiber stack without pop: the owner takes the whole list at once, so there is no ABA problem
+    void ThreadCache::pushRemote(void* block, size_t sizeClass)
+    {
+        FreeBlock* node{ static_cast<FreeBlock*>(block) };
+        node->m_next = m_remote[sizeClass].load(std::memory_order_relaxed);
+        while (!m_remote[sizeClass].compare_exchange_weak(
+            node->m_next, node, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    // 1. blocks freed by other threads, 2. a magazine from the depot, 3. a new slab
+    void ThreadCache::refill(size_t sizeClass)
+    {
+        LocalList& list{ m_local[sizeClass] };
+
+        FreeBlock* remote{ m_remote[sizeClass].exchange(nullptr, std::memory_order_acquire) };
+        if (remote != nullptr) {
+            list.m_head = remote;
+            for (; remote != nullptr; remote = remote->m_next) {
+                ++list.m_count;
+            }
+            return;
+        }
+
+        ThreadCachingHeap& heap{ ThreadCachingHeap::instance() };
+
+        FreeBlock* magazine{ heap.takeMagazine(sizeClass) };
+        if (magazine != nullptr) {
+            list.m_head = magazine;
+            list.m_count = MagazineSize;
+            return;
+        }
+
+        list.m_head = heap.newSlab(this, sizeClass);
+        list.m_count = (SlabSize - sizeof(SlabHeader)) / blockSize(sizeClass);
+    }
+
+    void ThreadCache::pushLocal(FreeBlock* block, size_t sizeClass)
+    {
+        LocalList& list{ m_local[sizeClass] };
+        block->m_next = list.m_head;
+        list.m_head = block;
+        ++list.m_count;
+    }
+
+    void ThreadCache::flush()
+    {
+        ThreadCachingHeap& heap{ ThreadCachingHeap::instance() };
+
+        for (size_t sizeClass{}; sizeClass != SizeClasses; ++sizeClass) {
+            LocalList& list{ m_local[sizeClass] };
+
+            while (list.m_count >= MagazineSize) {
+                FreeBlock* magazine{ list.m_head };
+                FreeBlock* last{ magazine };
+                for (size_t i{ 1 }; i != MagazineSize; ++i) {
+                    last = last->m_next;
+                }
+                list.m_head = last->m_next;
+                list.m_count -= MagazineSize;
+                last->m_next = nullptr;
+                heap.putMagazine(magazine, sizeClass);
+            }
+            // a partial magazine stays with the cache until it is adopted
+        }
+    }
+
+    // =================================================================================
+
+    ThreadCachingHeap::~ThreadCachingHeap()
+    {
+        for (void* slab : m_slabs) {
+            ::operator delete(slab, std::align_val_t{ SlabSize });
+        }
+    }
+
+    ThreadCachingHeap& ThreadCachingHeap::instance()
+    {
+        static ThreadCachingHeap heap;
+        return heap;
+    }
+
+    void* ThreadCachingHeap::allocate(size_t bytes)
+    {
+        if (bytes == 0 || bytes > MaxBlockSize) {
+            return ::operator new(bytes);
+        }
+        return currentCache()->allocate(sizeClass(bytes));
+    }
+
+    void ThreadCachingHeap::deallocate(void* ptr, size_t bytes) noexcept
+    {
+        if (bytes == 0 || bytes > MaxBlockSize) {
+            ::operator delete(ptr);
+            return;
+        }
+        currentCache()->deallocate(ptr, sizeClass(bytes));
+    }
+
+    ThreadCache* ThreadCachingHeap::acquireCache()
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        if (!m_abandonedCaches.empty()) {
+            ThreadCache* cache{ m_abandonedCaches.back() };
+            m_abandonedCaches.pop_back();
+            return cache;
+        }
+
+        m_caches.push_back(std::make_unique<ThreadCache>());
+        return m_caches.back().get();
+    }
+
+    void ThreadCachingHeap::releaseCache(ThreadCache* cache)
+    {
+        cache->flush();
+
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        m_abandonedCaches.push_back(cache);
+    }
+
+    FreeBlock* ThreadCachingHeap::takeMagazine(size_t sizeClass)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+
+        std::vector<FreeBlock*>& magazines{ m_depot[sizeClass] };
+        if (magazines.empty()) {
+            return nullptr;
+        }
+
+        FreeBlock* magazine{ magazines.back() };
+        magazines.pop_back();
+        return magazine;
+    }
+
+    void ThreadCachingHeap::putMagazine(FreeBlock* magazine, size_t sizeClass)
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        m_depot[sizeClass].push_back(magazine);
+    }
+
+    FreeBlock* ThreadCachingHeap::newSlab(ThreadCache* owner, size_t sizeClass)
+    {
+        char* slab{ static_cast<char*>(::operator new(SlabSize, std::align_val_t{ SlabSize })) };
+        {
+            std::lock_guard<std::mutex> guard{ m_mutex };
+            m_slabs.push_back(slab);
+        }
+
+        SlabHeader* header{ reinterpret_cast<SlabHeader*>(slab) };
+        header->m_owner = owner;
+        header->m_sizeClass = sizeClass;
+
+        size_t size{ blockSize(sizeClass) };
+        size_t count{ (SlabSize - sizeof(SlabHeader)) / size };
+        char* first{ slab + sizeof(SlabHeader) };
+
+        for (size_t i{}; i != count; ++i) {
+            FreeBlock* block{ reinterpret_cast<FreeBlock*>(first + i * size) };
+            block->m_next = (i + 1 != count) ? reinterpret_cast<FreeBlock*>(first + (i + 1) * size) : nullptr;
+        }
+        return reinterpret_cast<FreeBlock*>(first);
+    }
+
+    size_t ThreadCachingHeap::slabs()
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        return m_slabs.size();
+    }
+
+    size_t ThreadCachingHeap::magazines()
+    {
+        std::lock_guard<std::mutex> guard{ m_mutex };
+        size_t count{};
+        for (const auto& magazines : m_depot) {
+            count += magazines.size();
+        }
+        return count;
+    }
+
+    // =================================================================================
+    // stateless C++11 allocator: usable with every standard container
+
+    template <typename T>
+    struct CachingAlloc {
+
+        typedef T value_type;
+
+        CachingAlloc() = default;
+
+        template <class TP>
+        CachingAlloc(const CachingAlloc<TP>&) {}
+
+        T* allocate(size_t n);
+        void deallocate(T* p, size_t n);
+    };
+
+    template <class T>
+    T* CachingAlloc<T>::allocate(size_t n) {
+        if (alignof(T) > Alignment) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ alignof(T) }));
+        }
+        return static_cast<T*>(ThreadCachingHeap::allocate(n * sizeof(T)));
+    }
+
+    template <class T>
+    void CachingAlloc<T>::deallocate(T* p, size_t n) {
+        if (alignof(T) > Alignment) {
+            ::operator delete(p, std::align_val_t{ alignof(T) });
+            return;
+        }
+        ThreadCachingHeap::deallocate(p, n * sizeof(T));
+    }
+
+    template <class T, class U>
+    bool operator==(const CachingAlloc<T>&, const CachingAlloc<U>&) {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const CachingAlloc<T>&, const CachingAlloc<U>&) {
+        return false;
+    }
+
+    // =================================================================================
+
+    void test_01_thread_cache_allocator() {
+
+        std::vector<std::thread> threads;
+        std::vector<long long> sums(4);
+
+        for (size_t t{}; t != sums.size(); ++t) {
+            threads.emplace_back([&, t]() {
+                std::list<int, CachingAlloc<int>> list;
+                for (int n = 1; n <= 10000; ++n) {
+                    list.push_back(n);
+                }
+                long long sum{};
+                for (int n : list) {
+                    sum += n;
+                }
+                sums[t] = sum;
+            });
+        }
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        for (long long sum : sums) {
+            std::cout << sum << ' ';   // 50005000
+        }
+        std::cout << std::endl;
+    }
+
+    // cross-thread frees: the consumer releases the nodes the producer allocated
+    void test_02_thread_cache_allocator() {
+
+        constexpr size_t Count{ 100000 };
+
+        std::mutex mutex;
+        std::vector<int*> handOver;
+        std::atomic<bool> done{ false };
+        CachingAlloc<int> alloc;
+
+        std::thread producer{ [&]() {
+            for (size_t i{}; i != Count; ++i) {
+                int* value{ alloc.allocate(1) };
+                *value = static_cast<int>(i);
+                std::lock_guard<std::mutex> guard{ mutex };
+                handOver.push_back(value);
+            }
+            done = true;
+        } };
+
+        size_t released{};
+        long long sum{};
+        std::thread consumer{ [&]() {
+            std::vector<int*> batch;
+            while (true) {
+                bool finished{ done };
+                {
+                    std::lock_guard<std::mutex> guard{ mutex };
+                    batch.swap(handOver);
+                }
+                for (int* value : batch) {
+                    sum += *value;
+                    alloc.deallocate(value, 1);   // pushed back to the producer's cache
+                    ++released;
+                }
+                batch.clear();
+                if (finished && released == Count) {
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        } };
+
+        producer.join();
+        consumer.join();
+
+        std::cout << "released " << released << " blocks of another thread, sum = " << sum << std::endl;
+        std::cout << "slabs: " << ThreadCachingHeap::instance().slabs()
+            << ", magazines in depot: " << ThreadCachingHeap::instance().magazines() << std::endl;
+    }
+
+    // =================================================================================
+    // benchmark: allocation throughput and latency for 1 to 64 threads
+
+    constexpr size_t OperationsPerThread{ 200000 };
+    constexpr size_t LiveBlocks{ 512 };        // working set of every thread
+    constexpr size_t SampleEvery{ 16 };        // every n-th allocation is timed
+
+    struct Measurement {
+        double seconds;
+        double p50;    // nanoseconds
+        double p99;    // nanoseconds
+    };
+
+    template <typename TAllocate, typename TDeallocate>
+    Measurement churn(size_t numThreads, TAllocate allocate, TDeallocate deallocate) {
+
+        using Clock = std::chrono::steady_clock;
+
+        std::vector<std::vector<double>> latencies(numThreads);
+        std::vector<std::thread> threads;
+        std::atomic<size_t> ready{ 0 };
+        std::atomic<bool> start{ false };
+
+        for (size_t t{}; t != numThreads; ++t) {
+            threads.emplace_back([&, t]() {
+                std::vector<void*> live(LiveBlocks, nullptr);
+                std::vector<double>& samples{ latencies[t] };
+                samples.reserve(OperationsPerThread / SampleEvery + 1);
+
+                ++ready;
+                while (!start) {
+                    std::this_thread::yield();
+                }
+
+                for (size_t i{}; i != OperationsPerThread; ++i) {
+                    size_t bytes{ 16 + 16 * (i % 8) };
+                    size_t slot{ i % LiveBlocks };
+
+                    if (live[slot] != nullptr) {
+                        deallocate(live[slot], 16 + 16 * ((i - LiveBlocks) % 8));
+                    }
+
+                    if (i % SampleEvery == 0) {
+                        auto begin{ Clock::now() };
+                        live[slot] = allocate(bytes);
+                        auto end{ Clock::now() };
+                        samples.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+                    }
+                    else {
+                        live[slot] = allocate(bytes);
+                    }
+                }
+
+                for (size_t i{ OperationsPerThread }; i != OperationsPerThread + LiveBlocks; ++i) {
+                    size_t slot{ i % LiveBlocks };
+                    if (live[slot] != nullptr) {
+                        deallocate(live[slot], 16 + 16 * ((i - LiveBlocks) % 8));
+                    }
+                }
+            });
+        }
+
+        while (ready != numThreads) {
+            std::this_thread::yield();
+        }
+
+        auto begin{ Clock::now() };
+        start = true;
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        auto end{ Clock::now() };
+
+        std::vector<double> all;
+        for (const auto& samples : latencies) {
+            all.insert(std::end(all), std::begin(samples), std::end(samples));
+        }
+
+        auto percentile = [&](double percent) {
+            size_t index{ static_cast<size_t>(percent / 100.0 * (all.size() - 1)) };
+            std::nth_element(std::begin(all), std::begin(all) + index, std::end(all));
+            return all[index];
+        };
+
+        return { std::chrono::duration<double>(end - begin).count(), percentile(50.0), percentile(99.0) };
+    }
+
+    void test_03_thread_cache_allocator_benchmark() {
+
+        std::cout << "Allocation churn per thread: " << OperationsPerThread << " operations, "
+            << LiveBlocks << " live blocks of 16..128 bytes (latency includes the clock overhead)" << std::endl;
+
+        auto print = [](const std::string& label, size_t numThreads, const Measurement& measurement) {
+            double operations{ static_cast<double>(numThreads * OperationsPerThread) };
+            std::cout << std::left << std::setw(16) << label << std::right
+                << std::setw(3) << numThreads << " threads: "
+                << std::fixed << std::setprecision(1)
+                << std::setw(8) << operations / measurement.seconds / 1e6 << " Mops/s, "
+                << "p50 " << std::setw(6) << measurement.p50 << " ns, "
+                << "p99 " << std::setw(8) << measurement.p99 << " ns" << std::endl;
+        };
+
+        // two calls of 'Clock::now' per sample
+        std::vector<double> overhead(1000);
+        for (double& sample : overhead) {
+            auto begin{ std::chrono::steady_clock::now() };
+            auto end{ std::chrono::steady_clock::now() };
+            sample = std::chrono::duration<double, std::nano>(end - begin).count();
+        }
+        std::nth_element(std::begin(overhead), std::begin(overhead) + overhead.size() / 2, std::end(overhead));
+        std::cout << "clock overhead: " << overhead[overhead.size() / 2] << " ns" << std::endl;
+
+        for (size_t numThreads{ 1 }; numThreads <= 64; numThreads *= 2) {
+
+            Measurement global{ churn(numThreads,
+                [](size_t bytes) { return ::operator new(bytes); },
+                [](void* ptr, size_t) { ::operator delete(ptr); }
+            ) };
+            print("::operator new", numThreads, global);
+
+            Measurement cached{ churn(numThreads,
+                [](size_t bytes) { return ThreadCachingHeap::allocate(bytes); },
+                [](void* ptr, size_t bytes) { ThreadCachingHeap::deallocate(ptr, bytes); }
+            ) };
+            print("thread cache", numThreads, cached);
+        }
+    }
+}
+
+void main_allocator_thread_cache()
+{
+    using namespace AllocatorThreadCache;
+    test_01_thread_cache_allocator();
+    test_02_thread_cache_allocator();
+    test_03_thread_cache_allocator_benchmark();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
@@ -20,6 +20,14 @@
 #include <iterator>
 #include <chrono>
 #include <thread>
+#include <memory>
+#include <iomanip>
+
+#include "../Global/Benchmark.h"
+#include "../Global/CowBuffer.h"
+#include "../Global/GrowthVector.h"
+#include "../Global/MappedMemory.h"
+#include "../Global/ProcessMemory.h"
 
 namespace Exercises {
 
@@ -73,6 +81,8 @@ namespace Exercises {
             size_t m_len;
             int* m_data;
 
+            static inline bool s_verbose{ true };
+
         public:
             HugeArray();        // default c'tor
             HugeArray(size_t);  // user-defined c'tor
@@ -87,31 +97,44 @@ namespace Exercises {
             HugeArray(HugeArray&&) noexcept;  // move c'tor
             HugeArray& operator= (HugeArray&&) noexcept; // move assignment
 #endif
+
+            // output of the special member functions, switched off for benchmarks
+            static void setVerbose(bool verbose) { s_verbose = verbose; }
         };
 
         HugeArray::HugeArray() : m_len(0), m_data(nullptr) {
-            std::cout << "default c'tor" << std::endl;
+            if (s_verbose) {
+                std::cout << "default c'tor" << std::endl;
+            }
         }
 
         HugeArray::HugeArray(size_t len) : m_len(len), m_data(new int[len]) {
-            std::cout << "c'tor (size_t):  " << len << " allocated" << std::endl;
+            if (s_verbose) {
+                std::cout << "c'tor (size_t):  " << len << " allocated" << std::endl;
+            }
         }
 
         HugeArray::~HugeArray() {
-            std::cout << "d'tor:           " << m_len << " relased" << std::endl;
+            if (s_verbose) {
+                std::cout << "d'tor:           " << m_len << " relased" << std::endl;
+            }
             delete[] m_data;
         }
 
         // copy semantics
         HugeArray::HugeArray(const HugeArray& other) {
-            std::cout << "COPY c'tor:      " << other.m_len << " allocated" << std::endl;
+            if (s_verbose) {
+                std::cout << "COPY c'tor:      " << other.m_len << " allocated" << std::endl;
+            }
             m_len = other.m_len;
             m_data = new int[other.m_len];
             std::copy(other.m_data, other.m_data + m_len, m_data);
         }
 
         HugeArray& HugeArray::operator=(const HugeArray& other) {
-            std::cout << "COPY assignment: " << other.m_len << " assigned" << std::endl;
+            if (s_verbose) {
+                std::cout << "COPY assignment: " << other.m_len << " assigned" << std::endl;
+            }
             if (this != &other) {
                 delete[] m_data;
                 m_len = other.m_len;
@@ -124,7 +147,9 @@ namespace Exercises {
 #if defined (SOLUTION)
         // move semantics
         HugeArray::HugeArray(HugeArray&& other) noexcept {  // move c'tor
-            std::cout << "MOVE c'tor:      " << other.m_len << " allocated" << std::endl;
+            if (s_verbose) {
+                std::cout << "MOVE c'tor:      " << other.m_len << " allocated" << std::endl;
+            }
             m_data = other.m_data;   // shallow copy
             m_len = other.m_len;
             other.m_data = nullptr;  // reset source object, ownership has been moved
@@ -132,7 +157,9 @@ namespace Exercises {
         }
 
         HugeArray& HugeArray::operator= (HugeArray&& other) noexcept { // move-assignment
-            std::cout << "MOVE assignment: " << other.m_len << " assigned" << std::endl;
+            if (s_verbose) {
+                std::cout << "MOVE assignment: " << other.m_len << " assigned" << std::endl;
+            }
             if (this != &other) {
                 delete[] m_data;         // release left side
                 m_data = other.m_data;   // shallow copy
@@ -157,6 +184,254 @@ namespace Exercises {
             auto diff = std::chrono::duration_cast<std::chrono::milliseconds> (end - start);
             std::cout << "Done [" << diff.count() << " msecs]" << std::endl;
         }
+
+        // opt-in copy-on-write variant: copies share the buffer,
+        // the first mutable access of a shared array copies it
+        class SharedHugeArray {
+        private:
+            CowBuffer<int> m_buffer;
+
+        public:
+            SharedHugeArray();        // default c'tor
+            SharedHugeArray(size_t);  // user-defined c'tor
+
+            // copy and move semantics of 'CowBuffer': copies are O(1)
+
+            size_t size() const;
+            const int* data() const;
+            int* mutableData();       // copies a shared buffer, valid until the next copy
+        };
+
+        SharedHugeArray::SharedHugeArray() {
+            std::cout << "default c'tor" << std::endl;
+        }
+
+        SharedHugeArray::SharedHugeArray(size_t len) : m_buffer(len) {
+            std::cout << "c'tor (size_t):  " << len << " allocated" << std::endl;
+        }
+
+        size_t SharedHugeArray::size() const {
+            return m_buffer.size();
+        }
+
+        const int* SharedHugeArray::data() const {
+            return m_buffer.data();
+        }
+
+        int* SharedHugeArray::mutableData() {
+            return m_buffer.mutableData();
+        }
+
+        void testExercise_02_copyOnWrite() {
+            std::cout << "Start:" << std::endl;
+            auto start = std::chrono::high_resolution_clock::now();
+            std::vector<SharedHugeArray> myVec;
+            SharedHugeArray bArray(10000000);
+            SharedHugeArray bArray2(bArray);       // shares the buffer
+            myVec.push_back(bArray);               // shares the buffer
+            bArray = SharedHugeArray(20000000);
+            myVec.push_back(SharedHugeArray(30000000));
+            bArray2.mutableData()[0] = 123;        // the only copy of 10000000 ints
+            auto end = std::chrono::high_resolution_clock::now();
+            auto diff = std::chrono::duration_cast<std::chrono::milliseconds> (end - start);
+            std::cout << "Done [" << diff.count() << " msecs]" << std::endl;
+        }
+
+        // storage backend for large arrays: anonymous memory mappings,
+        // zero-filled lazily by the operating system, optionally with transparent huge pages,
+        // resizing without copying (mremap)
+        class MappedHugeArray {
+        private:
+            MappedMemory::Mapping m_mapping;
+
+        public:
+            MappedHugeArray();
+            MappedHugeArray(size_t, MappedMemory::PageSize = MappedMemory::PageSize::Normal);
+
+            // copy semantics
+            MappedHugeArray(const MappedHugeArray&);
+            MappedHugeArray& operator=(const MappedHugeArray&);
+
+            // move semantics: the mapping changes its owner
+            MappedHugeArray(MappedHugeArray&&) noexcept = default;
+            MappedHugeArray& operator= (MappedHugeArray&&) noexcept = default;
+
+            size_t size() const;
+            int* data() const;
+            void resize(size_t);  // new elements are 0
+        };
+
+        MappedHugeArray::MappedHugeArray() {}
+
+        MappedHugeArray::MappedHugeArray(size_t len, MappedMemory::PageSize pageSize)
+            : m_mapping(len * sizeof(int), pageSize) {}
+
+        MappedHugeArray::MappedHugeArray(const MappedHugeArray& other)
+            : m_mapping(other.m_mapping.bytes(), other.m_mapping.pageSize()) {
+            std::cout << "COPY c'tor:      " << other.size() << " allocated" << std::endl;
+            std::copy(other.data(), other.data() + other.size(), data());
+        }
+
+        MappedHugeArray& MappedHugeArray::operator=(const MappedHugeArray& other) {
+            std::cout << "COPY assignment: " << other.size() << " assigned" << std::endl;
+            if (this != &other) {
+                MappedHugeArray copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        size_t MappedHugeArray::size() const {
+            return m_mapping.bytes() / sizeof(int);
+        }
+
+        int* MappedHugeArray::data() const {
+            return static_cast<int*>(m_mapping.data());
+        }
+
+        void MappedHugeArray::resize(size_t len) {
+            m_mapping.resize(len * sizeof(int));
+        }
+
+        // elapsed time and page faults of one step
+        template <typename TFunction>
+        void measureStep(const std::string& label, TFunction function) {
+            size_t faults = ProcessMemory::current().minorFaults;
+            auto start = std::chrono::high_resolution_clock::now();
+            function();
+            Benchmarking::clobberMemory();
+            auto end = std::chrono::high_resolution_clock::now();
+            faults = ProcessMemory::current().minorFaults - faults;
+
+            auto diff = std::chrono::duration_cast<std::chrono::microseconds> (end - start);
+            std::cout << std::left << std::setw(40) << label << std::right
+                << std::setw(8) << diff.count() / 1000.0 << " msecs, "
+                << std::setw(7) << faults << " page faults" << std::endl;
+        }
+
+        void testExercise_02_mappedStorage() {
+
+            constexpr size_t Len = 30000000;
+
+            // construction: 'new int[len]()' zeroes every element up front
+            // (the optimizer must not remove unused buffers)
+            measureStep("new int[len]", [&]() {
+                std::unique_ptr<int[]> data(new int[Len]);
+                Benchmarking::doNotOptimize(data[0]);
+            });
+            measureStep("new int[len]()", [&]() {
+                std::unique_ptr<int[]> data(new int[Len]());
+                Benchmarking::doNotOptimize(data[0]);
+            });
+            measureStep("MappedHugeArray", [&]() {
+                MappedHugeArray data(Len);
+                Benchmarking::doNotOptimize(data.data()[0]);
+            });
+
+            // construction and first write access of every element
+            measureStep("new int[len] + fill", [&]() {
+                std::unique_ptr<int[]> data(new int[Len]);
+                std::fill(data.get(), data.get() + Len, 1);
+                Benchmarking::doNotOptimize(data[Len - 1]);
+            });
+            measureStep("MappedHugeArray + fill", [&]() {
+                MappedHugeArray data(Len);
+                std::fill(data.data(), data.data() + Len, 1);
+                Benchmarking::doNotOptimize(data.data()[Len - 1]);
+            });
+            measureStep("MappedHugeArray (huge pages) + fill", [&]() {
+                MappedHugeArray data(Len, MappedMemory::PageSize::Huge);
+                std::fill(data.data(), data.data() + Len, 1);
+                Benchmarking::doNotOptimize(data.data()[Len - 1]);
+            });
+
+            // growing from 10000000 to 30000000 elements
+            std::unique_ptr<int[]> small(new int[Len / 3]);
+            std::fill(small.get(), small.get() + Len / 3, 1);
+            measureStep("grow: new int[len] + copy", [&]() {
+                std::unique_ptr<int[]> large(new int[Len]);
+                std::copy(small.get(), small.get() + Len / 3, large.get());
+                Benchmarking::doNotOptimize(large[0]);
+            });
+
+            MappedHugeArray mapped(Len / 3);
+            std::fill(mapped.data(), mapped.data() + Len / 3, 1);
+            measureStep("grow: MappedHugeArray::resize", [&]() { mapped.resize(Len); });
+            std::cout << "elements: " << mapped.size() << ", first: " << mapped.data()[0]
+                << ", last: " << mapped.data()[Len - 1] << std::endl;
+        }
+    }
+}
+
+// 'HugeArray' owns its elements through a plain pointer: it may be moved by memcpy
+template <>
+struct is_trivially_relocatable<Exercises::Exercise_02::HugeArray> : std::true_type {};
+
+namespace Exercises {
+
+    namespace Exercise_02 {
+
+        // growing a std::vector moves every element (MOVE c'tor and d'tor),
+        // a 'GrowthVector' relocates trivially relocatable elements with realloc / memmove
+        void testExercise_02_relocation() {
+            std::cout << "std::vector<HugeArray>:" << std::endl;
+            {
+                std::vector<HugeArray> myVec;
+                for (int i = 0; i < 5; ++i) {
+                    myVec.emplace_back(1000000);
+                }
+            }
+
+            std::cout << "GrowthVector<HugeArray>:" << std::endl;
+            {
+                GrowthVector<HugeArray> myVec;
+                for (int i = 0; i < 5; ++i) {
+                    myVec.emplace_back(1000000);
+                }
+                myVec.erase(myVec.begin());
+            }
+        }
+
+        // the same without console output: move c'tor calls vs. realloc / memmove
+        template <typename TVector>
+        void addRelocationCases(Benchmarking::Benchmark& benchmark, const std::string& name) {
+
+            benchmark.add(name + ", emplace_back", [](size_t size) -> Benchmarking::Benchmark::Function {
+                return [=]() {
+                    TVector vec;
+                    for (size_t i{}; i != size; ++i) {
+                        vec.emplace_back(16);
+                    }
+                    Benchmarking::doNotOptimize(vec.data());
+                };
+            });
+
+            benchmark.add(name + ", insert + erase at front", [](size_t size) -> Benchmarking::Benchmark::Function {
+                auto vec{ std::make_shared<TVector>() };
+                for (size_t i{}; i != size; ++i) {
+                    vec->emplace_back(16);
+                }
+                return [=]() {
+                    for (size_t i{}; i != 100; ++i) {
+                        vec->emplace(vec->begin(), 16);
+                        vec->erase(vec->begin());
+                    }
+                    Benchmarking::doNotOptimize(vec->data());
+                };
+            });
+        }
+
+        void testExercise_02_relocationBenchmark() {
+
+            HugeArray::setVerbose(false);
+
+            Benchmarking::Benchmark benchmark{ "std::vector<HugeArray> vs. GrowthVector<HugeArray>" };
+            addRelocationCases<std::vector<HugeArray>>(benchmark, "std::vector<HugeArray(16)>");
+            addRelocationCases<GrowthVector<HugeArray>>(benchmark, "GrowthVector<HugeArray(16)>");
+            benchmark.run({ 1000, 100000 });
+
+            HugeArray::setVerbose(true);
+        }
     }
 
     namespace Exercise_03 {
@@ -1910,6 +2185,10 @@ void main_exercices()
 
     //testExercise_01();
     //testExercise_02();
+    //testExercise_02_copyOnWrite();
+    //testExercise_02_mappedStorage();
+    //testExercise_02_relocation();
+    //testExercise_02_relocationBenchmark();
     //testExercise_03();
     //testExercise_04();  
     //testExercise_05();
@@ -3,9 +3,66 @@
 // =====================================================================================
 
 #include <iostream>
+#include <fstream>
 #include <string>
 #include <vector>
+#include <array>
 #include <chrono> 
+#include <cmath>
+#include <type_traits>
+#include <initializer_list>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "../Global/Benchmark.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define EXPRESSION_TEMPLATES_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Visual C++ accepts every intrinsic regardless of the /arch switch.
+// GCC and Clang need the instruction set on each function using it,
+// 'flatten' inlines the whole expression tree into the SIMD kernel
+#if defined(_MSC_VER)
+#define TARGET_SSE2
+#define TARGET_AVX2
+#define TARGET_AVX512
+#define KERNEL_SSE2
+#define KERNEL_AVX2
+#define KERNEL_AVX512
+#else
+#define TARGET_SSE2   __attribute__((target("sse2")))
+#define TARGET_AVX2   __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#define KERNEL_SSE2   __attribute__((target("sse2"), flatten))
+#define KERNEL_AVX2   __attribute__((target("avx2"), flatten))
+#define KERNEL_AVX512 __attribute__((target("avx512f"), flatten))
+#endif
+
+// GCC warns (-Wpsabi) about every function passing or returning a packet by value
+// outside of a SIMD target, because the calling convention for such vectors depends
+// on the instruction set. No such call remains: 'flatten' inlines all packet functions
+// into the kernel compiled for that instruction set, so the warning is disabled here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wpsabi"
+#endif
 
 namespace ExpressionTemplates {
 
@@ -24,103 +81,865 @@ namespace ExpressionTemplates {
     constexpr size_t Cols{ BenchmarkRows };  // <== modify values here
     constexpr size_t Rows{ BenchmarkRows };  // <== modify values here
 
-    class Matrix {
+    // parallel evaluation
+    constexpr bool ParallelEvaluation{ true };
+    constexpr size_t ParallelThreshold{ 256 * 1024 };  // minimum number of elements
+    constexpr size_t TileBytes{ 64 * 1024 };           // destination bytes per tile
+
+    // ========================================================================
+    // SIMD support: instruction sets and packet types
+
+    enum class InstructionSet { Scalar, SSE2, AVX2, AVX512 };
+
+    std::string toString(InstructionSet instructionSet)
+    {
+        switch (instructionSet) {
+        case InstructionSet::SSE2:   return "SSE2";
+        case InstructionSet::AVX2:   return "AVX2";
+        case InstructionSet::AVX512: return "AVX-512";
+        default:                     return "Scalar";
+        }
+    }
+
+    InstructionSet detectInstructionSet()
+    {
+#if defined(EXPRESSION_TEMPLATES_X86) && defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 0);
+        int maxLeaf{ info[0] };
+
+        __cpuid(info, 1);
+        bool sse2{ (info[3] & (1 << 26)) != 0 };
+        bool osxsave{ (info[2] & (1 << 27)) != 0 };
+
+        // operating system must save the YMM / ZMM registers on context switches
+        unsigned long long xcr0{ osxsave ? _xgetbv(0) : 0 };
+        bool ymmEnabled{ (xcr0 & 0x06) == 0x06 };
+        bool zmmEnabled{ (xcr0 & 0xE6) == 0xE6 };
+
+        bool avx2{ false };
+        bool avx512{ false };
+        if (maxLeaf >= 7) {
+            __cpuidex(info, 7, 0);
+            avx2 = (info[1] & (1 << 5)) != 0;
+            avx512 = (info[1] & (1 << 16)) != 0;
+        }
+
+        if (avx512 && zmmEnabled) return InstructionSet::AVX512;
+        if (avx2 && ymmEnabled) return InstructionSet::AVX2;
+        if (sse2) return InstructionSet::SSE2;
+#elif defined(EXPRESSION_TEMPLATES_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return InstructionSet::AVX512;
+        if (__builtin_cpu_supports("avx2")) return InstructionSet::AVX2;
+        if (__builtin_cpu_supports("sse2")) return InstructionSet::SSE2;
+#endif
+        return InstructionSet::Scalar;
+    }
+
+    // CPU detection is done only once
+    InstructionSet getInstructionSet()
+    {
+        static const InstructionSet instructionSet{ detectInstructionSet() };
+        return instructionSet;
+    }
+
+    // a packet type describes how many doubles are processed at once
+    // and provides load, store and arithmetic for this register width
+    struct ScalarPacket
+    {
+        using Type = double;
+        static constexpr size_t Width{ 1 };
+
+        constexpr static Type load(const double* p) { return *p; }
+        constexpr static void store(double* p, Type value) { *p = value; }
+        constexpr static Type broadcast(double value) { return value; }
+        constexpr static Type add(Type a, Type b) { return a + b; }
+        constexpr static Type sub(Type a, Type b) { return a - b; }
+        constexpr static Type mul(Type a, Type b) { return a * b; }
+        constexpr static Type div(Type a, Type b) { return a / b; }
+        static Type sqrt(Type a) { return std::sqrt(a); }
+        static Type abs(Type a) { return std::fabs(a); }
+        constexpr static Type min(Type a, Type b) { return a < b ? a : b; }
+        constexpr static Type max(Type a, Type b) { return a > b ? a : b; }
+    };
+
+#if defined(EXPRESSION_TEMPLATES_X86)
+    struct SSE2Packet
+    {
+        using Type = __m128d;
+        static constexpr size_t Width{ 2 };
+
+        TARGET_SSE2 static Type load(const double* p) { return _mm_loadu_pd(p); }
+        TARGET_SSE2 static void store(double* p, Type value) { _mm_storeu_pd(p, value); }
+        TARGET_SSE2 static Type broadcast(double value) { return _mm_set1_pd(value); }
+        TARGET_SSE2 static Type add(Type a, Type b) { return _mm_add_pd(a, b); }
+        TARGET_SSE2 static Type sub(Type a, Type b) { return _mm_sub_pd(a, b); }
+        TARGET_SSE2 static Type mul(Type a, Type b) { return _mm_mul_pd(a, b); }
+        TARGET_SSE2 static Type div(Type a, Type b) { return _mm_div_pd(a, b); }
+        TARGET_SSE2 static Type sqrt(Type a) { return _mm_sqrt_pd(a); }
+        TARGET_SSE2 static Type abs(Type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+        TARGET_SSE2 static Type min(Type a, Type b) { return _mm_min_pd(a, b); }
+        TARGET_SSE2 static Type max(Type a, Type b) { return _mm_max_pd(a, b); }
+    };
+
+    struct AVX2Packet
+    {
+        using Type = __m256d;
+        static constexpr size_t Width{ 4 };
+
+        TARGET_AVX2 static Type load(const double* p) { return _mm256_loadu_pd(p); }
+        TARGET_AVX2 static void store(double* p, Type value) { _mm256_storeu_pd(p, value); }
+        TARGET_AVX2 static Type broadcast(double value) { return _mm256_set1_pd(value); }
+        TARGET_AVX2 static Type add(Type a, Type b) { return _mm256_add_pd(a, b); }
+        TARGET_AVX2 static Type sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+        TARGET_AVX2 static Type mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+        TARGET_AVX2 static Type div(Type a, Type b) { return _mm256_div_pd(a, b); }
+        TARGET_AVX2 static Type sqrt(Type a) { return _mm256_sqrt_pd(a); }
+        TARGET_AVX2 static Type abs(Type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+        TARGET_AVX2 static Type min(Type a, Type b) { return _mm256_min_pd(a, b); }
+        TARGET_AVX2 static Type max(Type a, Type b) { return _mm256_max_pd(a, b); }
+    };
+
+    struct AVX512Packet
+    {
+        using Type = __m512d;
+        static constexpr size_t Width{ 8 };
+
+        TARGET_AVX512 static Type load(const double* p) { return _mm512_loadu_pd(p); }
+        TARGET_AVX512 static void store(double* p, Type value) { _mm512_storeu_pd(p, value); }
+        TARGET_AVX512 static Type broadcast(double value) { return _mm512_set1_pd(value); }
+        TARGET_AVX512 static Type add(Type a, Type b) { return _mm512_add_pd(a, b); }
+        TARGET_AVX512 static Type sub(Type a, Type b) { return _mm512_sub_pd(a, b); }
+        TARGET_AVX512 static Type mul(Type a, Type b) { return _mm512_mul_pd(a, b); }
+        TARGET_AVX512 static Type div(Type a, Type b) { return _mm512_div_pd(a, b); }
+        // sqrt, min and max with a full mask: the unmasked intrinsics of GCC 12 start
+        // from an undefined register and trigger -Wmaybe-uninitialized when inlined
+        TARGET_AVX512 static Type sqrt(Type a) { return _mm512_mask_sqrt_pd(a, 0xFF, a); }
+        TARGET_AVX512 static Type abs(Type a) { return _mm512_abs_pd(a); }
+        TARGET_AVX512 static Type min(Type a, Type b) { return _mm512_mask_min_pd(a, 0xFF, a, b); }
+        TARGET_AVX512 static Type max(Type a, Type b) { return _mm512_mask_max_pd(a, 0xFF, a, b); }
+    };
+#endif
+
+    // evaluates the linear index range [first, last) of an expression,
+    // remaining elements at the end of the span are computed one by one
+    template <typename TPacket, typename TEXPR>
+    inline void evaluateSpan(double* dest, const TEXPR& expr, size_t first, size_t last)
+    {
+        size_t index{ first };
+        for (; index + TPacket::Width <= last; index += TPacket::Width) {
+            TPacket::store(dest + index, expr.template packet<TPacket>(index));
+        }
+        for (; index < last; ++index) {
+            dest[index] = expr.template packet<ScalarPacket>(index);
+        }
+    }
+
+#if defined(EXPRESSION_TEMPLATES_X86)
+    template <typename TEXPR>
+    KERNEL_SSE2 void evaluateSpanSSE2(double* dest, const TEXPR& expr, size_t first, size_t last)
+    {
+        evaluateSpan<SSE2Packet>(dest, expr, first, last);
+    }
+
+    template <typename TEXPR>
+    KERNEL_AVX2 void evaluateSpanAVX2(double* dest, const TEXPR& expr, size_t first, size_t last)
+    {
+        evaluateSpan<AVX2Packet>(dest, expr, first, last);
+    }
+
+    template <typename TEXPR>
+    KERNEL_AVX512 void evaluateSpanAVX512(double* dest, const TEXPR& expr, size_t first, size_t last)
+    {
+        evaluateSpan<AVX512Packet>(dest, expr, first, last);
+    }
+#endif
+
+    template <typename TEXPR>
+    void evaluateSpan(InstructionSet instructionSet, double* dest, const TEXPR& expr, size_t first, size_t last)
+    {
+        switch (instructionSet) {
+#if defined(EXPRESSION_TEMPLATES_X86)
+        case InstructionSet::AVX512:
+            evaluateSpanAVX512(dest, expr, first, last);
+            break;
+        case InstructionSet::AVX2:
+            evaluateSpanAVX2(dest, expr, first, last);
+            break;
+        case InstructionSet::SSE2:
+            evaluateSpanSSE2(dest, expr, first, last);
+            break;
+#endif
+        default:
+            evaluateSpan<ScalarPacket>(dest, expr, first, last);
+            break;
+        }
+    }
+
+    // ========================================================================
+    // thread pool: the calling thread and the workers pick tasks
+    // from a shared counter until all tasks of a 'run' are done.
+    // One 'run' at a time: a caller finding the pool busy - another thread,
+    // or a task of the running job itself - executes its tasks serially.
+    // The first exception thrown by a task skips the remaining tasks and
+    // is rethrown by 'run' after all threads have left the job
+
+    class ThreadPool
+    {
     private:
-        size_t m_cols;
-        size_t m_rows;
-        std::vector<double> m_values;
+        std::vector<std::thread> m_workers;
+        std::mutex m_runMutex;  // held by the calling thread for a whole 'run'
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+        const std::function<void(size_t)>* m_task;
+        size_t m_numTasks;
+        std::atomic<size_t> m_nextTask;
+        size_t m_activeWorkers;
+        size_t m_generation;
+        bool m_shutdown;
+        std::exception_ptr m_exception;
+
+        // pool whose tasks the current thread is executing (worker or caller of 'run')
+        static inline thread_local const ThreadPool* t_pool{ nullptr };
+
+        // sets 't_pool' for the duration of a 'run', restores it on every path
+        class PoolScope
+        {
+        private:
+            const ThreadPool* m_previous;
+
+        public:
+            explicit PoolScope(const ThreadPool* pool) : m_previous{ std::exchange(t_pool, pool) } {}
+            ~PoolScope() { t_pool = m_previous; }
+
+            PoolScope(const PoolScope&) = delete;
+            PoolScope& operator=(const PoolScope&) = delete;
+        };
 
     public:
-        // c'tor(s)
-        Matrix() : Matrix(Cols, Rows) {}
+        // c'tor / d'tor
+        explicit ThreadPool(size_t numThreads) 
+            : m_task{ nullptr }, m_numTasks{}, m_nextTask{}, 
+              m_activeWorkers{}, m_generation{}, m_shutdown{ false }
+        {
+            // the calling thread takes part in the work, too
+            for (size_t i{ 1 }; i < numThreads; ++i) {
+                m_workers.emplace_back([this]() { workerLoop(); });
+            }
+        }
+
+        ~ThreadPool()
+        {
+            {
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                m_shutdown = true;
+            }
+            m_start.notify_all();
+            for (std::thread& worker : m_workers) {
+                worker.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        // getter
+        size_t size() const { return m_workers.size() + 1; }
+
+        // executes task(0), ..., task(numTasks - 1) and returns when all are done
+        void run(size_t numTasks, const std::function<void(size_t)>& task)
+        {
+            if (m_workers.empty() || numTasks <= 1 || t_pool == this) {
+                runSerial(numTasks, task);
+                return;
+            }
+
+            std::unique_lock<std::mutex> running{ m_runMutex, std::try_to_lock };
+            if (!running.owns_lock()) {
+                runSerial(numTasks, task);
+                return;
+            }
+
+            PoolScope scope{ this };
+
+            {
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                m_task = &task;
+                m_numTasks = numTasks;
+                m_nextTask = 0;
+                m_activeWorkers = m_workers.size();
+                m_exception = nullptr;
+                ++m_generation;
+            }
+            m_start.notify_all();
+
+            processTasks(task, numTasks);
+
+            // the workers still refer to 'task' until they are done
+            std::exception_ptr exception{};
+            {
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_done.wait(lock, [this]() { return m_activeWorkers == 0; });
+                m_task = nullptr;
+                exception = std::exchange(m_exception, nullptr);
+            }
+
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+    private:
+        static void runSerial(size_t numTasks, const std::function<void(size_t)>& task)
+        {
+            for (size_t i{}; i != numTasks; ++i) {
+                task(i);
+            }
+        }
+
+        // does not throw: the first exception is stored for 'run'
+        void processTasks(const std::function<void(size_t)>& task, size_t numTasks) noexcept
+        {
+            try {
+                for (size_t i{ m_nextTask++ }; i < numTasks; i = m_nextTask++) {
+                    task(i);
+                }
+            }
+            catch (...) {
+                m_nextTask = numTasks;  // remaining tasks are skipped
+
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                if (!m_exception) {
+                    m_exception = std::current_exception();
+                }
+            }
+        }
 
-        Matrix(size_t cols, size_t rows) : m_cols{ cols }, m_rows{ rows }
+        void workerLoop()
         {
-            m_values.resize(cols*rows);
+            t_pool = this;
+            size_t generation{};
+            while (true) {
+                const std::function<void(size_t)>* task{};
+                size_t numTasks{};
+                {
+                    std::unique_lock<std::mutex> lock{ m_mutex };
+                    m_start.wait(lock, [&]() { return m_shutdown || m_generation != generation; });
+                    if (m_shutdown) {
+                        return;
+                    }
+                    generation = m_generation;
+                    task = m_task;
+                    numTasks = m_numTasks;
+                }
+
+                processTasks(*task, numTasks);
+
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                if (--m_activeWorkers == 0) {
+                    m_done.notify_one();
+                }
+            }
+        }
+    };
+
+    // default pool, one thread per hardware thread
+    ThreadPool& getThreadPool()
+    {
+        static ThreadPool pool{ std::max<size_t>(1, std::thread::hardware_concurrency()) };
+        return pool;
+    }
+
+    // ========================================================================
+
+    // matrix product (GEMM), see below
+    template <typename T>
+    struct IsGemmExpression;
+
+    template <typename T>
+    struct ContainsProduct;
+
+    // ========================================================================
+    // storage order of the elements: element (x, y) is found at 'index(x, y, ...)'
+
+    struct RowMajor {
+        static constexpr size_t index(size_t x, size_t y, size_t cols, size_t) {
+            return y * cols + x;
+        }
+    };
+
+    struct ColMajor {
+        static constexpr size_t index(size_t x, size_t y, size_t, size_t rows) {
+            return x * rows + y;
+        }
+    };
+
+    struct AnyLayout {};    // scalars fit into every layout
+    struct MixedLayout {};  // operands with different layouts, no common linear order
+
+    // layout of the linear index space of an expression, see below
+    template <typename T>
+    struct LayoutOf;
+
+    template <typename TEXPR, typename TLayout>
+    constexpr bool HasLayout =
+        std::is_same_v<typename LayoutOf<TEXPR>::type, TLayout> ||
+        std::is_same_v<typename LayoutOf<TEXPR>::type, AnyLayout>;
+
+    // ========================================================================
+    // allocator returning memory aligned to 'Alignment' bytes (SIMD registers, cache lines)
+
+    constexpr size_t Alignment{ 64 };
+
+    template <typename T, size_t TAlignment>
+    struct AlignedAllocator {
+
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind {
+            using other = AlignedAllocator<U, TAlignment>;
+        };
+
+        AlignedAllocator() = default;
+
+        template <typename U>
+        AlignedAllocator(const AlignedAllocator<U, TAlignment>&) {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{ TAlignment }));
         }
 
+        void deallocate(T* p, size_t) {
+            ::operator delete(p, std::align_val_t{ TAlignment });
+        }
+    };
+
+    template <typename T, typename U, size_t TAlignment>
+    bool operator==(const AlignedAllocator<T, TAlignment>&, const AlignedAllocator<U, TAlignment>&) {
+        return true;
+    }
+
+    template <typename T, typename U, size_t TAlignment>
+    bool operator!=(const AlignedAllocator<T, TAlignment>&, const AlignedAllocator<U, TAlignment>&) {
+        return false;
+    }
+
+    // ========================================================================
+    // matrix class: the elements are taken from an allocator, small matrices
+    // (up to 'InlineCapacity' elements) are stored inside of the object itself
+
+    template <
+        typename TAllocator = AlignedAllocator<double, Alignment>,
+        size_t InlineCapacity = DefaultCols * DefaultRows,
+        typename TLayout = RowMajor>
+    class BasicMatrix {
+    private:
+        static_assert(std::is_same_v<typename TAllocator::value_type, double>,
+            "Allocator must provide elements of type double");
+
+        using AllocatorTraits = std::allocator_traits<TAllocator>;
+
+        size_t m_cols;
+        size_t m_rows;
+        TAllocator m_allocator;
+        double* m_values;
+        alignas(Alignment) std::array<double, InlineCapacity> m_inline;
+
+    public:
+        using allocator_type = TAllocator;
+        using layout_type = TLayout;
+
+        // c'tor(s) and d'tor
+        BasicMatrix() : BasicMatrix(Cols, Rows) {}
+        BasicMatrix(size_t cols, size_t rows, const TAllocator& allocator = TAllocator{});
+        ~BasicMatrix();
+
+        // copy and move semantics
+        BasicMatrix(const BasicMatrix& other);
+        BasicMatrix(BasicMatrix&& other) noexcept;
+
         // getter
         size_t inline getCols() const { return m_cols; };
         size_t inline getRows() const { return m_rows; };
+        size_t inline size() const { return m_cols * m_rows; };
+        bool inline isInline() const { return m_values == m_inline.data(); }
+        TAllocator get_allocator() const { return m_allocator; }
+
+        // raw access to the contiguous element storage
+        const double* data() const { return m_values; }
+        double* data() { return m_values; }
+
+        // packet access to the linear index space (SIMD evaluation)
+        template <typename TPacket>
+        typename TPacket::Type packet(size_t index) const {
+            return TPacket::load(m_values + index);
+        }
 
         // functor - representing index operator
         const double& operator()(size_t x, size_t y) const;
         double& operator()(size_t x, size_t y);
 
         // operator= --> classical definition
-        Matrix& operator=(const Matrix& rhs);
+        BasicMatrix& operator=(const BasicMatrix& rhs);
+        BasicMatrix& operator=(BasicMatrix&& rhs) noexcept(
+            AllocatorTraits::propagate_on_container_move_assignment::value ||
+            AllocatorTraits::is_always_equal::value);
 
         // operator= --> expression template approach (template member method)
         template <typename TEXPR>
-        Matrix& operator=(const TEXPR& expression);
+        BasicMatrix& operator=(const TEXPR& expression);
+
+        // evaluation of expression templates
+        template <typename TEXPR>
+        void evaluate(const TEXPR& expression, InstructionSet instructionSet);
+
+        template <typename TEXPR>
+        void evaluateParallel(const TEXPR& expression, InstructionSet instructionSet, ThreadPool& pool);
+
+        template <typename TEXPR>
+        void evaluateByIndex(const TEXPR& expression);
+
+        template <typename TEXPR>
+        void evaluateBlocked(const TEXPR& expression, ThreadPool* pool);
+
+    private:
+        // chooses linear (SIMD) or blocked evaluation
+        template <typename TEXPR>
+        void assign(const TEXPR& expression);
+
+        // private helper methods
+        void allocate();
+        void release() noexcept;
     };
 
-    const double& Matrix::operator()(size_t x, size_t y) const {
+    using Matrix = BasicMatrix<>;
+    using ColMajorMatrix = BasicMatrix<AlignedAllocator<double, Alignment>, DefaultCols * DefaultRows, ColMajor>;
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>::BasicMatrix(size_t cols, size_t rows, const TAllocator& allocator)
+        : m_cols{ cols }, m_rows{ rows }, m_allocator{ allocator }, m_values{ nullptr }, m_inline{}
+    {
+        allocate();
+        std::fill(m_values, m_values + size(), 0.0);
+    }
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>::~BasicMatrix() {
+        release();
+    }
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>::BasicMatrix(const BasicMatrix& other)
+        : m_cols{ other.m_cols }, m_rows{ other.m_rows },
+          m_allocator{ AllocatorTraits::select_on_container_copy_construction(other.m_allocator) },
+          m_values{ nullptr }, m_inline{}
+    {
+        allocate();
+        std::copy(other.m_values, other.m_values + size(), m_values);
+    }
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>::BasicMatrix(BasicMatrix&& other) noexcept
+        : m_cols{ other.m_cols }, m_rows{ other.m_rows },
+          m_allocator{ std::move(other.m_allocator) },
+          m_values{ nullptr }, m_inline{}
+    {
+        if (other.isInline()) {
+            // inline elements can't be stolen, they are copied
+            m_values = m_inline.data();
+            std::copy(other.m_values, other.m_values + size(), m_values);
+        }
+        else {
+            m_values = other.m_values;  // shallow copy
+        }
+
+        // reset source object
+        other.m_cols = 0;
+        other.m_rows = 0;
+        other.m_values = other.m_inline.data();
+    }
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    const double& BasicMatrix<TAllocator, InlineCapacity, TLayout>::operator()(size_t x, size_t y) const {
         //if constexpr (Verbose) {
         //    std::cout << "Matrix::operator() => [" << x << ',' << y << ']' << std::endl;
         //}
-        return m_values[y * getCols() + x];
+        return m_values[TLayout::index(x, y, m_cols, m_rows)];
     }
 
-    double& Matrix::operator()(size_t x, size_t y) {
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    double& BasicMatrix<TAllocator, InlineCapacity, TLayout>::operator()(size_t x, size_t y) {
         //if constexpr (Verbose) {
         //    std::cout << "Matrix::operator() => [" << x << ',' << y << ']' << std::endl;
         //}
-        return m_values[y * getCols() + x];
+        return m_values[TLayout::index(x, y, m_cols, m_rows)];
     }
 
-    // classical operator+ definition
-    Matrix operator+(const Matrix& lhs, const Matrix& rhs)
-    {
-        Matrix result{ lhs.getCols(), lhs.getRows() };
+    // private helper methods
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    void BasicMatrix<TAllocator, InlineCapacity, TLayout>::allocate() {
+        if (size() <= InlineCapacity) {
+            m_values = m_inline.data();
+        }
+        else {
+            m_values = AllocatorTraits::allocate(m_allocator, size());
+        }
+    }
 
-        for (size_t y{}; y != lhs.getRows(); ++y) {
-            for (size_t x{}; x != lhs.getCols(); ++x) {
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    void BasicMatrix<TAllocator, InlineCapacity, TLayout>::release() noexcept {
+        if (!isInline()) {
+            AllocatorTraits::deallocate(m_allocator, m_values, size());
+        }
+        m_values = m_inline.data();
+    }
 
-                if constexpr (Verbose) {
-                    double l {lhs(x, y)};
-                    double r {rhs(x, y)};
-                    std::cout << "Matrix:: adding " << l << '+' << r << std::endl;
-                    double tmp{ l + r };
-                    std::cout << "Matrix:: assigning result " << tmp << std::endl;
-                    result(x, y) = tmp;
-                }
-                else {
-                    result(x, y) = lhs(x, y) + rhs(x, y);
+    // classical operator+ definition - placed into a namespace of its own,
+    // otherwise 'a + b' would never be handled by the expression templates
+    namespace Classical {
+
+        Matrix operator+(const Matrix& lhs, const Matrix& rhs)
+        {
+            Matrix result{ lhs.getCols(), lhs.getRows() };
+
+            for (size_t y{}; y != lhs.getRows(); ++y) {
+                for (size_t x{}; x != lhs.getCols(); ++x) {
+
+                    if constexpr (Verbose) {
+                        double l {lhs(x, y)};
+                        double r {rhs(x, y)};
+                        std::cout << "Matrix:: adding " << l << '+' << r << std::endl;
+                        double tmp{ l + r };
+                        std::cout << "Matrix:: assigning result " << tmp << std::endl;
+                        result(x, y) = tmp;
+                    }
+                    else {
+                        result(x, y) = lhs(x, y) + rhs(x, y);
+                    }
                 }
             }
+            return result;
         }
-        return result;
     }
 
     // classical operator= implementation
-    Matrix& Matrix::operator=(const Matrix& rhs) {
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>& 
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>::operator=(const BasicMatrix& rhs) {
 
         // prevent self-assignment
         if (this != &rhs) {
-            m_values = rhs.m_values;
+
+            // storage is reused if possible
+            bool reallocate{ size() != rhs.size() };
+            if (reallocate) {
+                release();
+            }
+
+            m_cols = rhs.m_cols;
+            m_rows = rhs.m_rows;
+            if (reallocate) {
+                allocate();
+            }
+
+            std::copy(rhs.m_values, rhs.m_values + size(), m_values);
+        }
+
+        return *this;
+    }
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>& 
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>::operator=(BasicMatrix&& rhs) noexcept(
+        AllocatorTraits::propagate_on_container_move_assignment::value ||
+        AllocatorTraits::is_always_equal::value) {
+
+        // prevent self-assignment
+        if (this == &rhs) {
+            return *this;
+        }
+
+        bool canSteal{ !rhs.isInline() && (
+            AllocatorTraits::propagate_on_container_move_assignment::value ||
+            m_allocator == rhs.m_allocator) };
+
+        if (canSteal) {
+            release();
+            if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value) {
+                m_allocator = std::move(rhs.m_allocator);
+            }
+            m_cols = rhs.m_cols;
+            m_rows = rhs.m_rows;
+            m_values = rhs.m_values;  // shallow copy
+
+            // reset source object
+            rhs.m_cols = 0;
+            rhs.m_rows = 0;
+            rhs.m_values = rhs.m_inline.data();
+        }
+        else {
+            // inline elements or foreign allocator: elements are copied
+            *this = static_cast<const BasicMatrix&>(rhs);
         }
 
         return *this;
     }
 
     // expression template approach: operator=
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    template <typename TEXPR>
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>& 
+    BasicMatrix<TAllocator, InlineCapacity, TLayout>::operator=(const TEXPR& expr) {
+        if constexpr (Verbose) {
+            evaluateByIndex(expr);
+        }
+        else if constexpr (ContainsProduct<TEXPR>::value && !std::is_same_v<TLayout, RowMajor>) {
+            // the GEMM kernel produces row-major results, these are transposed afterwards
+            BasicMatrix<TAllocator, InlineCapacity, RowMajor> tmp{ getCols(), getRows(), m_allocator };
+            tmp = expr;
+            assign(tmp);
+        }
+        else if constexpr (IsGemmExpression<TEXPR>::value && HasLayout<TEXPR, RowMajor>) {
+            evaluateGemm(*this, expr);
+        }
+        else if constexpr (ContainsProduct<TEXPR>::value) {
+            // the product reads its factors while the result is written
+            BasicMatrix tmp{ getCols(), getRows(), m_allocator };
+            tmp.assign(expr);
+            *this = std::move(tmp);
+        }
+        else if constexpr (!HasLayout<TEXPR, TLayout>) {
+            // 'a = transpose(a)': the blocked evaluation would overwrite
+            // elements of 'a' which are read later in transposed order
+            if (readsTransposed(expr, m_values, false)) {
+                BasicMatrix tmp{ getCols(), getRows(), m_allocator };
+                tmp.assign(expr);
+                *this = std::move(tmp);
+            }
+            else {
+                assign(expr);
+            }
+        }
+        else {
+            assign(expr);
+        }
+        return *this;
+    }
+
+    // operands stored in the layout of the destination are evaluated along their
+    // common linear index space, all others (e.g. transposed ones) in blocks
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    template <typename TEXPR>
+    void BasicMatrix<TAllocator, InlineCapacity, TLayout>::assign(const TEXPR& expr) {
+        bool parallel{ ParallelEvaluation && size() >= ParallelThreshold };
+
+        if constexpr (!HasLayout<TEXPR, TLayout>) {
+            evaluateBlocked(expr, parallel ? &getThreadPool() : nullptr);
+        }
+        else if (parallel) {
+            evaluateParallel(expr, getInstructionSet(), getThreadPool());
+        }
+        else {
+            evaluate(expr, getInstructionSet());
+        }
+    }
+
+    // vectorized evaluation over the contiguous storage of the matrix
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    template <typename TEXPR>
+    void BasicMatrix<TAllocator, InlineCapacity, TLayout>::evaluate(const TEXPR& expr, InstructionSet instructionSet) {
+        evaluateSpan(instructionSet, m_values, expr, 0, size());
+    }
+
+    // multi-threaded evaluation: the rows of the destination are split into tiles
+    // of about 'TileBytes' bytes. Each tile starts at a multiple of the widest packet,
+    // so every element is computed by exactly the same instructions as in the serial
+    // evaluation - the results are bit-identical
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
     template <typename TEXPR>
-    Matrix& Matrix::operator=(const TEXPR& expr) {
+    void BasicMatrix<TAllocator, InlineCapacity, TLayout>::evaluateParallel(
+        const TEXPR& expr, InstructionSet instructionSet, ThreadPool& pool) {
+
+        constexpr size_t MaxPacketWidth{ 8 };
+
+        size_t rowsPerTile{ std::max<size_t>(1, TileBytes / (sizeof(double) * getCols())) };
+        size_t tileSize{ rowsPerTile * getCols() };
+        tileSize = (tileSize + MaxPacketWidth - 1) / MaxPacketWidth * MaxPacketWidth;
+        size_t numTiles{ (size() + tileSize - 1) / tileSize };
+
+        double* dest{ m_values };
+        size_t total{ size() };
+
+        pool.run(numTiles, [&](size_t tile) {
+            size_t first{ tile * tileSize };
+            size_t last{ std::min(first + tileSize, total) };
+            evaluateSpan(instructionSet, dest, expr, first, last);
+        });
+    }
+
+    // element-wise evaluation, one (x, y) call chain per element
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    template <typename TEXPR>
+    void BasicMatrix<TAllocator, InlineCapacity, TLayout>::evaluateByIndex(const TEXPR& expr) {
         for (size_t y{}; y != getRows(); ++y) {
             for (size_t x{}; x != getCols(); ++x) {
 
                 if constexpr (Verbose) {
                     double sum{ expr(x, y) };
                     std::cout << "Matrix::    assigning expression result " << sum << std::endl;
-                    m_values[y * getCols() + x] = sum;
+                    (*this)(x, y) = sum;
                 }
                 else {
-                    m_values[y * getCols() + x] = expr(x, y);
+                    (*this)(x, y) = expr(x, y);
                 }
             }
         }
-        return *this;
+    }
+
+    // evaluation of operands with different layouts: the destination is written
+    // along its storage order, but in square blocks - the strided reads of the
+    // other operands then stay within the cache (blocked transpose)
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    template <typename TEXPR>
+    void BasicMatrix<TAllocator, InlineCapacity, TLayout>::evaluateBlocked(const TEXPR& expr, ThreadPool* pool) {
+
+        constexpr size_t BlockSize{ 32 };
+        constexpr bool IsRowMajor{ std::is_same_v<TLayout, RowMajor> };
+
+        // extents of the destination in storage order
+        size_t outer{ IsRowMajor ? getRows() : getCols() };
+        size_t inner{ IsRowMajor ? getCols() : getRows() };
+        size_t numBands{ (outer + BlockSize - 1) / BlockSize };
+
+        double* dest{ m_values };
+
+        auto evaluateBand = [&](size_t band) {
+            size_t outerFirst{ band * BlockSize };
+            size_t outerLast{ std::min(outerFirst + BlockSize, outer) };
+
+            for (size_t innerFirst{}; innerFirst < inner; innerFirst += BlockSize) {
+                size_t innerLast{ std::min(innerFirst + BlockSize, inner) };
+
+                for (size_t o{ outerFirst }; o != outerLast; ++o) {
+                    double* line{ dest + o * inner };
+                    for (size_t i{ innerFirst }; i != innerLast; ++i) {
+                        line[i] = IsRowMajor ? expr(i, o) : expr(o, i);
+                    }
+                }
+            }
+        };
+
+        if (pool != nullptr) {
+            pool->run(numBands, evaluateBand);
+        }
+        else {
+            for (size_t band{}; band != numBands; ++band) {
+                evaluateBand(band);
+            }
+        }
     }
 
     // ========================================================================
@@ -133,40 +952,1106 @@ namespace ExpressionTemplates {
                 result(x, y) = a(x, y) + b(x, y) + c(x, y);
             }
         }
-        return result;
-    }
+        return result;
+    }
+
+    // ========================================================================
+
+    // expression nodes:
+    // a 'Matrix' operand is referenced, all other nodes are small and stored
+    // by value - so an expression may outlive the temporaries it was built from
+
+    struct Expression {};  // tag base class of all expression nodes
+
+    template <typename T>
+    struct IsMatrix : std::false_type {};
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    struct IsMatrix<BasicMatrix<TAllocator, InlineCapacity, TLayout>> : std::true_type {};
+
+    template <typename T>
+    constexpr bool IsExpression = std::is_base_of_v<Expression, T> || IsMatrix<T>::value;
+
+    template <typename T>
+    using Operand = std::conditional_t<IsMatrix<T>::value, const T&, const T>;
+
+    // operations: one packet type covers both the scalar and the SIMD case
+    struct AddOp {
+        static constexpr char Symbol{ '+' };
+        template <typename TPacket>
+        static constexpr typename TPacket::Type apply(const typename TPacket::Type& a, const typename TPacket::Type& b) {
+            return TPacket::add(a, b);
+        }
+    };
+
+    struct SubOp {
+        static constexpr char Symbol{ '-' };
+        template <typename TPacket>
+        static constexpr typename TPacket::Type apply(const typename TPacket::Type& a, const typename TPacket::Type& b) {
+            return TPacket::sub(a, b);
+        }
+    };
+
+    struct MulOp {
+        static constexpr char Symbol{ '*' };
+        template <typename TPacket>
+        static constexpr typename TPacket::Type apply(const typename TPacket::Type& a, const typename TPacket::Type& b) {
+            return TPacket::mul(a, b);
+        }
+    };
+
+    struct DivOp {
+        static constexpr char Symbol{ '/' };
+        template <typename TPacket>
+        static constexpr typename TPacket::Type apply(const typename TPacket::Type& a, const typename TPacket::Type& b) {
+            return TPacket::div(a, b);
+        }
+    };
+
+    struct NegateOp {
+        template <typename TPacket>
+        constexpr typename TPacket::Type apply(const typename TPacket::Type& a) const {
+            return TPacket::sub(TPacket::broadcast(0.0), a);
+        }
+    };
+
+    struct SqrtOp {
+        template <typename TPacket>
+        typename TPacket::Type apply(const typename TPacket::Type& a) const {
+            return TPacket::sqrt(a);
+        }
+    };
+
+    struct AbsOp {
+        template <typename TPacket>
+        typename TPacket::Type apply(const typename TPacket::Type& a) const {
+            return TPacket::abs(a);
+        }
+    };
+
+    // arbitrary scalar function, applied lane by lane
+    template <typename TFunctor>
+    struct MapOp {
+        TFunctor m_functor;
+
+        template <typename TPacket>
+        typename TPacket::Type apply(const typename TPacket::Type& a) const {
+            double lanes[TPacket::Width];
+            TPacket::store(lanes, a);
+            for (double& lane : lanes) {
+                lane = m_functor(lane);
+            }
+            return TPacket::load(lanes);
+        }
+    };
+
+    // ========================================================================
+
+    template <typename TOp, typename LHS, typename RHS>
+    class BinaryExpr : public Expression
+    {
+    private:
+        Operand<LHS> m_lhs;
+        Operand<RHS> m_rhs;
+
+    public:
+        constexpr BinaryExpr(const LHS& lhs, const RHS& rhs) : m_lhs{ lhs }, m_rhs{ rhs } {}
+
+        // getter
+        constexpr const LHS& lhs() const { return m_lhs; }
+        constexpr const RHS& rhs() const { return m_rhs; }
+
+        constexpr double operator() (size_t x, size_t y) const {
+
+            if constexpr (Verbose) {
+                double l { m_lhs(x, y) };
+                double r { m_rhs(x, y) };
+                std::cout << "BinaryExpr:: " << l << TOp::Symbol << r << std::endl;
+                double tmp{ TOp::template apply<ScalarPacket>(l, r) };
+                return tmp;
+            }
+            else {
+                return TOp::template apply<ScalarPacket>(m_lhs(x, y), m_rhs(x, y));
+            }
+        }
+
+        template <typename TPacket>
+        typename TPacket::Type packet(size_t index) const {
+            return TOp::template apply<TPacket>(
+                m_lhs.template packet<TPacket>(index),
+                m_rhs.template packet<TPacket>(index)
+            );
+        }
+    };
+
+    // addition node, name kept from the first version of this snippet
+    template <typename LHS, typename RHS>
+    using MatrixExpr = BinaryExpr<AddOp, LHS, RHS>;
+
+    // scalar broadcast node
+    class ScalarExpr : public Expression
+    {
+    private:
+        double m_value;
+
+    public:
+        constexpr explicit ScalarExpr(double value) : m_value{ value } {}
+
+        constexpr double operator() (size_t, size_t) const {
+            return m_value;
+        }
+
+        template <typename TPacket>
+        typename TPacket::Type packet(size_t) const {
+            return TPacket::broadcast(m_value);
+        }
+    };
+
+    // unary map node
+    template <typename TOp, typename EXPR>
+    class UnaryExpr : public Expression
+    {
+    private:
+        Operand<EXPR> m_expr;
+        TOp m_op;
+
+    public:
+        constexpr UnaryExpr(const EXPR& expr, TOp op) : m_expr{ expr }, m_op{ op } {}
+
+        // getter
+        constexpr const EXPR& operand() const { return m_expr; }
+
+        constexpr double operator() (size_t x, size_t y) const {
+            return m_op.template apply<ScalarPacket>(m_expr(x, y));
+        }
+
+        template <typename TPacket>
+        typename TPacket::Type packet(size_t index) const {
+            return m_op.template apply<TPacket>(m_expr.template packet<TPacket>(index));
+        }
+    };
+
+    // transposed view, no elements are copied: the linear index space of the
+    // operand is kept, only its layout is reinterpreted (row-major <-> column-major)
+    template <typename EXPR>
+    class TransposeExpr : public Expression
+    {
+    private:
+        Operand<EXPR> m_expr;
+
+    public:
+        constexpr explicit TransposeExpr(const EXPR& expr) : m_expr{ expr } {}
+
+        // getter
+        constexpr const EXPR& operand() const { return m_expr; }
+
+        constexpr double operator() (size_t x, size_t y) const {
+            return m_expr(y, x);
+        }
+
+        template <typename TPacket>
+        typename TPacket::Type packet(size_t index) const {
+            return m_expr.template packet<TPacket>(index);
+        }
+    };
+
+    // ========================================================================
+    // operators and functions building expression trees
+
+    template <typename T, typename = std::enable_if_t<IsExpression<T>>>
+    constexpr const T& toExpression(const T& expr) {
+        return expr;
+    }
+
+    // every arithmetic type ('int', 'float', ...) becomes a 'double' scalar
+    template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>, typename = void>
+    constexpr ScalarExpr toExpression(T value) {
+        return ScalarExpr{ static_cast<double>(value) };
+    }
+
+    // at least one operand is an expression, the other one may be a scalar
+    template <typename LHS, typename RHS>
+    constexpr bool IsBinaryOperation =
+        (IsExpression<LHS> && IsExpression<RHS>) ||
+        (IsExpression<LHS> && std::is_arithmetic_v<RHS>) ||
+        (std::is_arithmetic_v<LHS> && IsExpression<RHS>);
+
+    template <typename T>
+    using ExpressionType = std::conditional_t<std::is_arithmetic_v<T>, ScalarExpr, T>;
+
+    template <typename TOp, typename LHS, typename RHS>
+    constexpr BinaryExpr<TOp, ExpressionType<LHS>, ExpressionType<RHS>> makeBinaryExpr(const LHS& lhs, const RHS& rhs) {
+        return { toExpression(lhs), toExpression(rhs) };
+    }
+
+    template <typename LHS, typename RHS, typename = std::enable_if_t<IsBinaryOperation<LHS, RHS>>>
+    constexpr auto operator+(const LHS& lhs, const RHS& rhs) {
+        return makeBinaryExpr<AddOp>(lhs, rhs);
+    }
+
+    template <typename LHS, typename RHS, typename = std::enable_if_t<IsBinaryOperation<LHS, RHS>>>
+    constexpr auto operator-(const LHS& lhs, const RHS& rhs) {
+        return makeBinaryExpr<SubOp>(lhs, rhs);
+    }
+
+    // note: element-wise product
+    template <typename LHS, typename RHS, typename = std::enable_if_t<IsBinaryOperation<LHS, RHS>>>
+    constexpr auto operator*(const LHS& lhs, const RHS& rhs) {
+        return makeBinaryExpr<MulOp>(lhs, rhs);
+    }
+
+    template <typename LHS, typename RHS, typename = std::enable_if_t<IsBinaryOperation<LHS, RHS>>>
+    constexpr auto operator/(const LHS& lhs, const RHS& rhs) {
+        return makeBinaryExpr<DivOp>(lhs, rhs);
+    }
+
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    constexpr UnaryExpr<NegateOp, EXPR> operator-(const EXPR& expr) {
+        return { expr, NegateOp{} };
+    }
+
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    UnaryExpr<SqrtOp, EXPR> sqrt(const EXPR& expr) {
+        return { expr, SqrtOp{} };
+    }
+
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    UnaryExpr<AbsOp, EXPR> abs(const EXPR& expr) {
+        return { expr, AbsOp{} };
+    }
+
+    template <typename EXPR, typename TFunctor, typename = std::enable_if_t<IsExpression<EXPR>>>
+    UnaryExpr<MapOp<TFunctor>, EXPR> map(const EXPR& expr, TFunctor functor) {
+        return { expr, MapOp<TFunctor>{ functor } };
+    }
+
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    constexpr TransposeExpr<EXPR> transpose(const EXPR& expr) {
+        return TransposeExpr<EXPR>{ expr };
+    }
+
+    // ========================================================================
+    // layout of the linear index space of an expression
+
+    template <typename TLayout>
+    struct TransposedLayout { using type = TLayout; };  // AnyLayout, MixedLayout
+
+    template <>
+    struct TransposedLayout<RowMajor> { using type = ColMajor; };
+
+    template <>
+    struct TransposedLayout<ColMajor> { using type = RowMajor; };
+
+    template <typename L1, typename L2>
+    struct CommonLayout { 
+        using type = std::conditional_t<std::is_same_v<L1, L2>, L1, MixedLayout>;
+    };
+
+    template <typename TLayout>
+    struct CommonLayout<AnyLayout, TLayout> { using type = TLayout; };
+
+    template <typename TLayout>
+    struct CommonLayout<TLayout, AnyLayout> { using type = TLayout; };
+
+    template <>
+    struct CommonLayout<AnyLayout, AnyLayout> { using type = AnyLayout; };
+
+    template <typename TAllocator, size_t InlineCapacity, typename TLayout>
+    struct LayoutOf<BasicMatrix<TAllocator, InlineCapacity, TLayout>> { using type = TLayout; };
+
+    template <>
+    struct LayoutOf<ScalarExpr> { using type = AnyLayout; };
+
+    template <typename TOp, typename LHS, typename RHS>
+    struct LayoutOf<BinaryExpr<TOp, LHS, RHS>> {
+        using type = typename CommonLayout<typename LayoutOf<LHS>::type, typename LayoutOf<RHS>::type>::type;
+    };
+
+    template <typename TOp, typename EXPR>
+    struct LayoutOf<UnaryExpr<TOp, EXPR>> : LayoutOf<EXPR> {};
+
+    template <typename EXPR>
+    struct LayoutOf<TransposeExpr<EXPR>> : TransposedLayout<typename LayoutOf<EXPR>::type> {};
+
+    // aliasing: does an expression read the elements at 'data' in another order
+    // than they are stored? Then they must not be overwritten during the evaluation
+
+    template <typename T, typename = std::enable_if_t<IsMatrix<T>::value>>
+    bool readsTransposed(const T& matrix, const double* data, bool transposed) {
+        return transposed && matrix.data() == data;
+    }
+
+    inline bool readsTransposed(const ScalarExpr&, const double*, bool) {
+        return false;
+    }
+
+    template <typename TOp, typename EXPR>
+    bool readsTransposed(const UnaryExpr<TOp, EXPR>& expr, const double* data, bool transposed) {
+        return readsTransposed(expr.operand(), data, transposed);
+    }
+
+    template <typename EXPR>
+    bool readsTransposed(const TransposeExpr<EXPR>& expr, const double* data, bool transposed) {
+        return readsTransposed(expr.operand(), data, !transposed);
+    }
+
+    template <typename TOp, typename LHS, typename RHS>
+    bool readsTransposed(const BinaryExpr<TOp, LHS, RHS>& expr, const double* data, bool transposed) {
+        return readsTransposed(expr.lhs(), data, transposed) || readsTransposed(expr.rhs(), data, transposed);
+    }
+
+    // ========================================================================
+    // matrix product (GEMM):
+    // 'operator*' is the element-wise product, the matrix product is written as
+    // 'product(a, b)'. Assigning 'product(a, b)' or 'product(a, b) + expr' to a
+    // matrix runs a cache-blocked kernel, the addition is fused into its epilogue
+
+    template <typename LHS, typename RHS>
+    class ProductExpr : public Expression
+    {
+    private:
+        const LHS& m_lhs;
+        const RHS& m_rhs;
+
+    public:
+        constexpr ProductExpr(const LHS& lhs, const RHS& rhs) : m_lhs{ lhs }, m_rhs{ rhs } {
+            if (lhs.getCols() != rhs.getRows()) {
+                throw std::invalid_argument("product: dimensions of operands do not match");
+            }
+        }
+
+        // getter
+        constexpr const LHS& lhs() const { return m_lhs; }
+        constexpr const RHS& rhs() const { return m_rhs; }
+        constexpr size_t getCols() const { return m_rhs.getCols(); }
+        constexpr size_t getRows() const { return m_lhs.getRows(); }
+
+        // element access without blocking - slow, used only when the product
+        // is part of a larger expression which cannot be mapped onto the GEMM kernel
+        constexpr double operator() (size_t x, size_t y) const {
+            double sum{};
+            for (size_t k{}; k != m_lhs.getCols(); ++k) {
+                sum += m_lhs(k, y) * m_rhs(x, k);
+            }
+            return sum;
+        }
+
+        template <typename TPacket>
+        typename TPacket::Type packet(size_t index) const {
+            double lanes[TPacket::Width];
+            for (size_t i{}; i != TPacket::Width; ++i) {
+                lanes[i] = (*this)((index + i) % getCols(), (index + i) / getCols());
+            }
+            return TPacket::load(lanes);
+        }
+    };
+
+    // the GEMM kernel expects row-major factors
+    template <typename LHS, typename RHS, 
+        typename = std::enable_if_t<IsMatrix<LHS>::value && IsMatrix<RHS>::value &&
+            HasLayout<LHS, RowMajor> && HasLayout<RHS, RowMajor>>>
+    constexpr ProductExpr<LHS, RHS> product(const LHS& lhs, const RHS& rhs) {
+        return { lhs, rhs };
+    }
+
+    // 'packet' of a product enumerates its elements row by row
+    template <typename LHS, typename RHS>
+    struct LayoutOf<ProductExpr<LHS, RHS>> { using type = RowMajor; };
+
+    template <typename T>
+    struct IsProduct : std::false_type {};
+
+    template <typename LHS, typename RHS>
+    struct IsProduct<ProductExpr<LHS, RHS>> : std::true_type {};
+
+    template <typename T>
+    struct ContainsProduct : IsProduct<T> {};
+
+    template <typename TOp, typename LHS, typename RHS>
+    struct ContainsProduct<BinaryExpr<TOp, LHS, RHS>>
+        : std::bool_constant<ContainsProduct<LHS>::value || ContainsProduct<RHS>::value> {};
+
+    template <typename TOp, typename EXPR>
+    struct ContainsProduct<UnaryExpr<TOp, EXPR>> : ContainsProduct<EXPR> {};
+
+    template <typename EXPR>
+    struct ContainsProduct<TransposeExpr<EXPR>> : ContainsProduct<EXPR> {};
+
+    template <typename T>
+    struct IsGemmExpression : std::bool_constant<IsProduct<T>::value> {};
+
+    template <typename LHS, typename RHS>
+    struct IsGemmExpression<BinaryExpr<AddOp, LHS, RHS>> 
+        : std::bool_constant<IsProduct<LHS>::value || IsProduct<RHS>::value> {};
+
+    // blocking parameters: a KC x NR panel of B stays in the L1 cache,
+    // a MC x KC block of A in the L2 cache and a KC x NC block of B in the L3 cache.
+    // The micro-kernel computes MR x NR elements, NR is two packets wide
+    constexpr size_t GemmMR{ 4 };
+    constexpr size_t GemmMC{ 128 };
+    constexpr size_t GemmKC{ 256 };
+    constexpr size_t GemmNC{ 4096 };
+
+    struct NoEpilogue {};
+
+    inline size_t roundUp(size_t value, size_t multiple) {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // packs a mc x kc block of A into panels of MR rows, padded with zeros
+    inline void gemmPackA(const double* values, size_t lda, 
+        size_t ic, size_t mc, size_t pc, size_t kc, double* packed)
+    {
+        for (size_t ir{}; ir < mc; ir += GemmMR) {
+            for (size_t p{}; p != kc; ++p) {
+                for (size_t r{}; r != GemmMR; ++r) {
+                    *packed++ = (ir + r < mc) ? values[(ic + ir + r) * lda + pc + p] : 0.0;
+                }
+            }
+        }
+    }
+
+    // packs a kc x nc block of B into panels of NR columns, padded with zeros
+    template <size_t NR>
+    void gemmPackB(const double* values, size_t ldb, 
+        size_t pc, size_t kc, size_t jc, size_t nc, double* packed)
+    {
+        for (size_t jr{}; jr < nc; jr += NR) {
+            for (size_t p{}; p != kc; ++p) {
+                const double* row{ values + (pc + p) * ldb + jc + jr };
+                for (size_t j{}; j != NR; ++j) {
+                    *packed++ = (jr + j < nc) ? row[j] : 0.0;
+                }
+            }
+        }
+    }
+
+    // computes a MR x NR tile of C, register blocked. The first pass over K
+    // writes 'A*B + epilogue', all following passes accumulate into C
+    template <typename TPacket, typename TEpilogue>
+    inline void gemmMicroKernel(size_t kc, const double* packedA, const double* packedB,
+        double* c, size_t ldc, size_t row, size_t col, size_t mr, size_t nr,
+        bool first, const TEpilogue& epilogue)
+    {
+        using Packet = typename TPacket::Type;
+        constexpr size_t W{ TPacket::Width };
+        constexpr size_t NR{ 2 * W };
+        constexpr bool HasEpilogue{ !std::is_same_v<TEpilogue, NoEpilogue> };
+
+        Packet acc[GemmMR][2];
+        for (size_t r{}; r != GemmMR; ++r) {
+            acc[r][0] = TPacket::broadcast(0.0);
+            acc[r][1] = TPacket::broadcast(0.0);
+        }
+
+        for (size_t p{}; p != kc; ++p) {
+            Packet b0{ TPacket::load(packedB + p * NR) };
+            Packet b1{ TPacket::load(packedB + p * NR + W) };
+            for (size_t r{}; r != GemmMR; ++r) {
+                Packet a{ TPacket::broadcast(packedA[p * GemmMR + r]) };
+                acc[r][0] = TPacket::add(acc[r][0], TPacket::mul(a, b0));
+                acc[r][1] = TPacket::add(acc[r][1], TPacket::mul(a, b1));
+            }
+        }
+
+        if (mr == GemmMR && nr == NR) {
+            for (size_t r{}; r != GemmMR; ++r) {
+                size_t index{ (row + r) * ldc + col };
+                for (size_t h{}; h != 2; ++h) {
+                    Packet value{ acc[r][h] };
+                    if (!first) {
+                        value = TPacket::add(TPacket::load(c + index + h * W), value);
+                    }
+                    else if constexpr (HasEpilogue) {
+                        value = TPacket::add(value, epilogue.template packet<TPacket>(index + h * W));
+                    }
+                    TPacket::store(c + index + h * W, value);
+                }
+            }
+        }
+        else {
+            // tile at the border of C
+            double tile[GemmMR][NR];
+            for (size_t r{}; r != GemmMR; ++r) {
+                TPacket::store(&tile[r][0], acc[r][0]);
+                TPacket::store(&tile[r][W], acc[r][1]);
+            }
+
+            for (size_t r{}; r != mr; ++r) {
+                for (size_t j{}; j != nr; ++j) {
+                    size_t index{ (row + r) * ldc + col + j };
+                    double value{ tile[r][j] };
+                    if (!first) {
+                        value = c[index] + value;
+                    }
+                    else if constexpr (HasEpilogue) {
+                        value = value + epilogue.template packet<ScalarPacket>(index);
+                    }
+                    c[index] = value;
+                }
+            }
+        }
+    }
+
+    // macro-kernel: packs a block of A and multiplies it with a packed block of B
+    template <typename TPacket, typename TEpilogue>
+    inline void gemmBlock(const double* a, size_t lda, const double* packedB, double* c, size_t ldc,
+        size_t ic, size_t mc, size_t jc, size_t nc, size_t pc, size_t kc, const TEpilogue& epilogue)
+    {
+        constexpr size_t NR{ 2 * TPacket::Width };
+
+        thread_local std::vector<double> packedA;
+        packedA.resize(roundUp(mc, GemmMR) * kc);
+        gemmPackA(a, lda, ic, mc, pc, kc, packedA.data());
+
+        for (size_t jr{}; jr < nc; jr += NR) {
+            for (size_t ir{}; ir < mc; ir += GemmMR) {
+                gemmMicroKernel<TPacket>(kc, packedA.data() + ir * kc, packedB + jr * kc,
+                    c, ldc, ic + ir, jc + jr, std::min(GemmMR, mc - ir), std::min(NR, nc - jr),
+                    pc == 0, epilogue);
+            }
+        }
+    }
+
+    template <typename TEpilogue>
+    using GemmBlockKernel = void(*)(const double*, size_t, const double*, double*, size_t,
+        size_t, size_t, size_t, size_t, size_t, size_t, const TEpilogue&);
+
+    template <typename TEpilogue>
+    void gemmBlockScalar(const double* a, size_t lda, const double* packedB, double* c, size_t ldc,
+        size_t ic, size_t mc, size_t jc, size_t nc, size_t pc, size_t kc, const TEpilogue& epilogue)
+    {
+        gemmBlock<ScalarPacket>(a, lda, packedB, c, ldc, ic, mc, jc, nc, pc, kc, epilogue);
+    }
+
+#if defined(EXPRESSION_TEMPLATES_X86)
+    template <typename TEpilogue>
+    KERNEL_SSE2 void gemmBlockSSE2(const double* a, size_t lda, const double* packedB, double* c, size_t ldc,
+        size_t ic, size_t mc, size_t jc, size_t nc, size_t pc, size_t kc, const TEpilogue& epilogue)
+    {
+        gemmBlock<SSE2Packet>(a, lda, packedB, c, ldc, ic, mc, jc, nc, pc, kc, epilogue);
+    }
+
+    template <typename TEpilogue>
+    KERNEL_AVX2 void gemmBlockAVX2(const double* a, size_t lda, const double* packedB, double* c, size_t ldc,
+        size_t ic, size_t mc, size_t jc, size_t nc, size_t pc, size_t kc, const TEpilogue& epilogue)
+    {
+        gemmBlock<AVX2Packet>(a, lda, packedB, c, ldc, ic, mc, jc, nc, pc, kc, epilogue);
+    }
+
+    template <typename TEpilogue>
+    KERNEL_AVX512 void gemmBlockAVX512(const double* a, size_t lda, const double* packedB, double* c, size_t ldc,
+        size_t ic, size_t mc, size_t jc, size_t nc, size_t pc, size_t kc, const TEpilogue& epilogue)
+    {
+        gemmBlock<AVX512Packet>(a, lda, packedB, c, ldc, ic, mc, jc, nc, pc, kc, epilogue);
+    }
+#endif
+
+    // loop nest around the macro-kernel, the blocks of A are distributed onto the thread pool.
+    // C (m x n) = A (m x k) * B (k x n), all matrices are stored row by row
+    template <typename TPacket, typename TEpilogue>
+    void gemm(double* c, const double* a, const double* b, size_t m, size_t n, size_t k,
+        const TEpilogue& epilogue, GemmBlockKernel<TEpilogue> blockKernel, ThreadPool* pool)
+    {
+        constexpr size_t NR{ 2 * TPacket::Width };
+
+        size_t numBlocks{ (m + GemmMC - 1) / GemmMC };
+
+        std::vector<double> packedB;
+
+        for (size_t jc{}; jc < n; jc += GemmNC) {
+            size_t nc{ std::min(GemmNC, n - jc) };
+
+            for (size_t pc{}; pc < k; pc += GemmKC) {
+                size_t kc{ std::min(GemmKC, k - pc) };
+
+                packedB.resize(roundUp(nc, NR) * kc);
+                gemmPackB<NR>(b, n, pc, kc, jc, nc, packedB.data());
+
+                auto task = [&](size_t block) {
+                    size_t ic{ block * GemmMC };
+                    blockKernel(a, k, packedB.data(), c, n,
+                        ic, std::min(GemmMC, m - ic), jc, nc, pc, kc, epilogue);
+                };
+
+                if (pool != nullptr) {
+                    pool->run(numBlocks, task);
+                }
+                else {
+                    for (size_t block{}; block != numBlocks; ++block) {
+                        task(block);
+                    }
+                }
+            }
+        }
+    }
+
+    // result = lhs * rhs + epilogue
+    template <typename TMatrix, typename LHS, typename RHS, typename TEpilogue>
+    void multiply(TMatrix& result, const ProductExpr<LHS, RHS>& product, const TEpilogue& epilogue,
+        InstructionSet instructionSet, ThreadPool* pool)
+    {
+        const LHS& a{ product.lhs() };
+        const RHS& b{ product.rhs() };
+
+        if (result.getRows() != a.getRows() || result.getCols() != b.getCols()) {
+            throw std::invalid_argument("product: dimensions of result do not match");
+        }
+
+        // the result must not overlap one of the factors
+        if (result.data() == a.data() || result.data() == b.data()) {
+            TMatrix tmp{ result.getCols(), result.getRows(), result.get_allocator() };
+            multiply(tmp, product, epilogue, instructionSet, pool);
+            result = std::move(tmp);
+            return;
+        }
+
+        // empty sum
+        if (a.getCols() == 0) {
+            if constexpr (std::is_same_v<TEpilogue, NoEpilogue>) {
+                std::fill(result.data(), result.data() + result.size(), 0.0);
+            }
+            else {
+                result.evaluate(epilogue, instructionSet);
+            }
+            return;
+        }
+
+        double* c{ result.data() };
+        size_t m{ a.getRows() };
+        size_t n{ b.getCols() };
+        size_t k{ a.getCols() };
+
+        switch (instructionSet) {
+#if defined(EXPRESSION_TEMPLATES_X86)
+        case InstructionSet::AVX512:
+            gemm<AVX512Packet>(c, a.data(), b.data(), m, n, k, epilogue, &gemmBlockAVX512<TEpilogue>, pool);
+            break;
+        case InstructionSet::AVX2:
+            gemm<AVX2Packet>(c, a.data(), b.data(), m, n, k, epilogue, &gemmBlockAVX2<TEpilogue>, pool);
+            break;
+        case InstructionSet::SSE2:
+            gemm<SSE2Packet>(c, a.data(), b.data(), m, n, k, epilogue, &gemmBlockSSE2<TEpilogue>, pool);
+            break;
+#endif
+        default:
+            gemm<ScalarPacket>(c, a.data(), b.data(), m, n, k, epilogue, &gemmBlockScalar<TEpilogue>, pool);
+            break;
+        }
+    }
+
+    // called by Matrix::operator= for 'product(a, b)' and 'product(a, b) + expr'
+    template <typename TMatrix, typename TEXPR>
+    void evaluateGemm(TMatrix& result, const TEXPR& expr)
+    {
+        InstructionSet instructionSet{ getInstructionSet() };
+
+        auto selectPool = [&](const auto& product) -> ThreadPool* {
+            size_t work{ result.size() * product.lhs().getCols() };
+            return (ParallelEvaluation && work >= ParallelThreshold) ? &getThreadPool() : nullptr;
+        };
+
+        if constexpr (IsProduct<TEXPR>::value) {
+            multiply(result, expr, NoEpilogue{}, instructionSet, selectPool(expr));
+        }
+        else if constexpr (IsProduct<std::decay_t<decltype(expr.lhs())>>::value) {
+            multiply(result, expr.lhs(), expr.rhs(), instructionSet, selectPool(expr.lhs()));
+        }
+        else {
+            multiply(result, expr.rhs(), expr.lhs(), instructionSet, selectPool(expr.rhs()));
+        }
+    }
+
+    // ========================================================================
+    // reductions: 'sum', 'norm', 'dot', 'minimum' and 'maximum' consume an
+    // expression directly - its elements are computed packet by packet and
+    // folded into accumulators, no temporary matrix is created
+
+    // dimensions of an expression, taken from its first matrix operand
+    struct Extent {
+        size_t cols;
+        size_t rows;
+    };
+
+    constexpr bool operator==(const Extent& lhs, const Extent& rhs) {
+        return lhs.cols == rhs.cols && lhs.rows == rhs.rows;
+    }
+
+    constexpr bool operator!=(const Extent& lhs, const Extent& rhs) {
+        return !(lhs == rhs);
+    }
+
+    template <typename T, typename = std::enable_if_t<IsMatrix<T>::value || IsProduct<T>::value>>
+    constexpr Extent extentOf(const T& matrix) {
+        return { matrix.getCols(), matrix.getRows() };
+    }
+
+    constexpr Extent extentOf(const ScalarExpr&) {
+        return { 0, 0 };
+    }
+
+    template <typename TOp, typename EXPR>
+    constexpr Extent extentOf(const UnaryExpr<TOp, EXPR>& expr) {
+        return extentOf(expr.operand());
+    }
+
+    template <typename EXPR>
+    constexpr Extent extentOf(const TransposeExpr<EXPR>& expr) {
+        Extent extent{ extentOf(expr.operand()) };
+        return { extent.rows, extent.cols };
+    }
+
+    template <typename TOp, typename LHS, typename RHS>
+    constexpr Extent extentOf(const BinaryExpr<TOp, LHS, RHS>& expr) {
+        Extent extent{ extentOf(expr.lhs()) };
+        return (extent.cols * extent.rows != 0) ? extent : extentOf(expr.rhs());
+    }
+
+    // Kahan summation: every lane of the packet keeps its own compensation term,
+    // the lanes and the partial results of the chunks are merged in a fixed order
+    struct SumReduction
+    {
+        template <typename TPacket>
+        struct Accumulator {
+            typename TPacket::Type sum;
+            typename TPacket::Type compensation;   // (computed sum) - (exact sum)
+        };
+
+        template <typename TPacket>
+        static Accumulator<TPacket> init() {
+            return { TPacket::broadcast(0.0), TPacket::broadcast(0.0) };
+        }
+
+        template <typename TPacket>
+        static void accumulate(Accumulator<TPacket>& acc, const typename TPacket::Type& value) {
+            typename TPacket::Type corrected{ TPacket::sub(value, acc.compensation) };
+            typename TPacket::Type sum{ TPacket::add(acc.sum, corrected) };
+            acc.compensation = TPacket::sub(TPacket::sub(sum, acc.sum), corrected);
+            acc.sum = sum;
+        }
+
+        static void merge(Accumulator<ScalarPacket>& acc, const Accumulator<ScalarPacket>& other) {
+            accumulate<ScalarPacket>(acc, other.sum);
+            accumulate<ScalarPacket>(acc, -other.compensation);
+        }
+
+        template <typename TPacket>
+        static Accumulator<ScalarPacket> finish(const Accumulator<TPacket>& acc) {
+            double sums[TPacket::Width];
+            double compensations[TPacket::Width];
+            TPacket::store(sums, acc.sum);
+            TPacket::store(compensations, acc.compensation);
+
+            Accumulator<ScalarPacket> result{ init<ScalarPacket>() };
+            for (size_t lane{}; lane != TPacket::Width; ++lane) {
+                merge(result, { sums[lane], compensations[lane] });
+            }
+            return result;
+        }
+
+        static double result(const Accumulator<ScalarPacket>& acc) {
+            return acc.sum - acc.compensation;
+        }
+    };
+
+    // sum of squares, the square is computed inside of the reduction,
+    // so the expression is evaluated only once per element
+    struct SquaredSumReduction : SumReduction
+    {
+        template <typename TPacket>
+        static void accumulate(Accumulator<TPacket>& acc, const typename TPacket::Type& value) {
+            SumReduction::accumulate<TPacket>(acc, TPacket::mul(value, value));
+        }
+    };
+
+    template <bool IsMinimum>
+    struct ExtremumReduction
+    {
+        template <typename TPacket>
+        struct Accumulator {
+            typename TPacket::Type value;
+        };
+
+        template <typename TPacket>
+        static Accumulator<TPacket> init() {
+            constexpr double Infinity{ std::numeric_limits<double>::infinity() };
+            return { TPacket::broadcast(IsMinimum ? Infinity : -Infinity) };
+        }
+
+        template <typename TPacket>
+        static void accumulate(Accumulator<TPacket>& acc, const typename TPacket::Type& value) {
+            if constexpr (IsMinimum) {
+                acc.value = TPacket::min(acc.value, value);
+            }
+            else {
+                acc.value = TPacket::max(acc.value, value);
+            }
+        }
+
+        static void merge(Accumulator<ScalarPacket>& acc, const Accumulator<ScalarPacket>& other) {
+            accumulate<ScalarPacket>(acc, other.value);
+        }
+
+        template <typename TPacket>
+        static Accumulator<ScalarPacket> finish(const Accumulator<TPacket>& acc) {
+            double values[TPacket::Width];
+            TPacket::store(values, acc.value);
+
+            Accumulator<ScalarPacket> result{ init<ScalarPacket>() };
+            for (double value : values) {
+                accumulate<ScalarPacket>(result, value);
+            }
+            return result;
+        }
+
+        static double result(const Accumulator<ScalarPacket>& acc) {
+            return acc.value;
+        }
+    };
+
+    using MinimumReduction = ExtremumReduction<true>;
+    using MaximumReduction = ExtremumReduction<false>;
+
+    // reduces the linear index range [first, last) of an expression
+    template <typename TReduction, typename TPacket, typename TEXPR>
+    inline typename TReduction::template Accumulator<ScalarPacket> 
+    reduceSpan(const TEXPR& expr, size_t first, size_t last)
+    {
+        auto acc{ TReduction::template init<TPacket>() };
+
+        size_t index{ first };
+        for (; index + TPacket::Width <= last; index += TPacket::Width) {
+            TReduction::template accumulate<TPacket>(acc, expr.template packet<TPacket>(index));
+        }
+
+        auto result{ TReduction::template finish<TPacket>(acc) };
+        for (; index < last; ++index) {
+            TReduction::template accumulate<ScalarPacket>(result, expr.template packet<ScalarPacket>(index));
+        }
+        return result;
+    }
+
+#if defined(EXPRESSION_TEMPLATES_X86)
+    template <typename TReduction, typename TEXPR>
+    KERNEL_SSE2 typename TReduction::template Accumulator<ScalarPacket>
+    reduceSpanSSE2(const TEXPR& expr, size_t first, size_t last)
+    {
+        return reduceSpan<TReduction, SSE2Packet>(expr, first, last);
+    }
+
+    template <typename TReduction, typename TEXPR>
+    KERNEL_AVX2 typename TReduction::template Accumulator<ScalarPacket>
+    reduceSpanAVX2(const TEXPR& expr, size_t first, size_t last)
+    {
+        return reduceSpan<TReduction, AVX2Packet>(expr, first, last);
+    }
+
+    template <typename TReduction, typename TEXPR>
+    KERNEL_AVX512 typename TReduction::template Accumulator<ScalarPacket>
+    reduceSpanAVX512(const TEXPR& expr, size_t first, size_t last)
+    {
+        return reduceSpan<TReduction, AVX512Packet>(expr, first, last);
+    }
+#endif
+
+    template <typename TReduction, typename TEXPR>
+    typename TReduction::template Accumulator<ScalarPacket> 
+    reduceSpan(InstructionSet instructionSet, const TEXPR& expr, size_t first, size_t last)
+    {
+        switch (instructionSet) {
+#if defined(EXPRESSION_TEMPLATES_X86)
+        case InstructionSet::AVX512:
+            return reduceSpanAVX512<TReduction>(expr, first, last);
+        case InstructionSet::AVX2:
+            return reduceSpanAVX2<TReduction>(expr, first, last);
+        case InstructionSet::SSE2:
+            return reduceSpanSSE2<TReduction>(expr, first, last);
+#endif
+        default:
+            return reduceSpan<TReduction, ScalarPacket>(expr, first, last);
+        }
+    }
+
+    // operands with different layouts: the elements are visited row by row
+    template <typename TReduction, typename TEXPR>
+    typename TReduction::template Accumulator<ScalarPacket> 
+    reduceSpanByIndex(const TEXPR& expr, size_t cols, size_t first, size_t last)
+    {
+        auto result{ TReduction::template init<ScalarPacket>() };
+
+        size_t x{ first % cols };
+        size_t y{ first / cols };
+        for (size_t index{ first }; index != last; ++index) {
+            TReduction::template accumulate<ScalarPacket>(result, expr(x, y));
+            if (++x == cols) {
+                x = 0;
+                ++y;
+            }
+        }
+        return result;
+    }
+
+    // the index space is split into chunks of a fixed size, independent of the
+    // number of threads - with or without a pool the partial results are the same
+    // and are merged in the same order, so the result does not depend on the pool
+    template <typename TReduction, typename TEXPR>
+    double reduce(const TEXPR& expr, ThreadPool* pool)
+    {
+        using Accumulator = typename TReduction::template Accumulator<ScalarPacket>;
+
+        constexpr size_t ChunkSize{ TileBytes / sizeof(double) };
+
+        InstructionSet instructionSet{ getInstructionSet() };
+        Extent extent{ extentOf(expr) };
+        size_t count{ extent.cols * extent.rows };
+        size_t numChunks{ (count + ChunkSize - 1) / ChunkSize };
+
+        auto reduceChunk = [&](size_t chunk) {
+            size_t first{ chunk * ChunkSize };
+            size_t last{ std::min(first + ChunkSize, count) };
+            if constexpr (std::is_same_v<typename LayoutOf<TEXPR>::type, MixedLayout>) {
+                return reduceSpanByIndex<TReduction>(expr, extent.cols, first, last);
+            }
+            else {
+                return reduceSpan<TReduction>(instructionSet, expr, first, last);
+            }
+        };
+
+        Accumulator result{ TReduction::template init<ScalarPacket>() };
+
+        if (pool != nullptr && pool->size() > 1 && count >= ParallelThreshold) {
+            std::vector<Accumulator> partials(numChunks);
+            pool->run(numChunks, [&](size_t chunk) {
+                partials[chunk] = reduceChunk(chunk);
+            });
+            for (const Accumulator& partial : partials) {
+                TReduction::merge(result, partial);
+            }
+        }
+        else {
+            for (size_t chunk{}; chunk != numChunks; ++chunk) {
+                TReduction::merge(result, reduceChunk(chunk));
+            }
+        }
+
+        return TReduction::result(result);
+    }
+
+    // public interface: pass a thread pool to reduce large expressions in parallel
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    double sum(const EXPR& expr, ThreadPool* pool = nullptr) {
+        return reduce<SumReduction>(expr, pool);
+    }
+
+    // Frobenius norm
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    double norm(const EXPR& expr, ThreadPool* pool = nullptr) {
+        return std::sqrt(reduce<SquaredSumReduction>(expr, pool));
+    }
+
+    template <typename LHS, typename RHS, 
+        typename = std::enable_if_t<IsExpression<LHS> && IsExpression<RHS>>>
+    double dot(const LHS& lhs, const RHS& rhs, ThreadPool* pool = nullptr) {
+        if (extentOf(lhs) != extentOf(rhs)) {
+            throw std::invalid_argument("dot: dimensions of operands do not match");
+        }
+        return reduce<SumReduction>(lhs * rhs, pool);
+    }
+
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    double minimum(const EXPR& expr, ThreadPool* pool = nullptr) {
+        return reduce<MinimumReduction>(expr, pool);
+    }
+
+    template <typename EXPR, typename = std::enable_if_t<IsExpression<EXPR>>>
+    double maximum(const EXPR& expr, ThreadPool* pool = nullptr) {
+        return reduce<MaximumReduction>(expr, pool);
+    }
+
+    // ========================================================================
+    // matrix with dimensions known at compile time: no heap and no loops at runtime,
+    // the assignment of an expression is unrolled completely and may be evaluated
+    // in constexpr contexts
+
+    template <size_t TRows, size_t TCols>
+    class FixedMatrix {
+    private:
+        std::array<double, TRows * TCols> m_values;
+
+    public:
+        // c'tor(s)
+        constexpr FixedMatrix() : m_values{} {}
+
+        // elements are given row by row, exactly 'TRows * TCols' of them:
+        // in a constant expression a wrong number does not compile
+        constexpr FixedMatrix(std::initializer_list<double> values) : m_values{} {
+            if (values.size() != size()) {
+                throw std::invalid_argument{ "FixedMatrix: wrong number of initial values" };
+            }
+
+            size_t index{};
+            for (double value : values) {
+                m_values[index++] = value;
+            }
+        }
+
+        template <typename TEXPR, typename = std::enable_if_t<IsExpression<TEXPR>>>
+        constexpr explicit FixedMatrix(const TEXPR& expr) : m_values{} {
+            *this = expr;
+        }
 
-    // ========================================================================
+        // getter
+        static constexpr size_t getCols() { return TCols; }
+        static constexpr size_t getRows() { return TRows; }
+        static constexpr size_t size() { return TRows * TCols; }
 
-    template <typename LHS, typename RHS>
-    class MatrixExpr
-    {
-    private:
-        const LHS& m_lhs;
-        const RHS& m_rhs;
+        // raw access to the contiguous element storage
+        constexpr const double* data() const { return m_values.data(); }
+        constexpr double* data() { return m_values.data(); }
 
-    public:
-        MatrixExpr(const LHS& lhs, const RHS& rhs) : m_rhs{ rhs }, m_lhs{ lhs } {}
+        // packet access to the linear index space (SIMD evaluation)
+        template <typename TPacket>
+        typename TPacket::Type packet(size_t index) const {
+            return TPacket::load(m_values.data() + index);
+        }
 
-        double operator() (size_t x, size_t y) const {
+        // functor - representing index operator
+        constexpr const double& operator()(size_t x, size_t y) const {
+            return m_values[y * TCols + x];
+        }
 
-            if constexpr (Verbose) {
-                double l { m_lhs(x, y) };
-                double r { m_rhs(x, y) };
-                std::cout << "MatrixExpr:: adding " << l << '+' << r << std::endl;
-                double tmp{ l + r };
-                return tmp;
+        constexpr double& operator()(size_t x, size_t y) {
+            return m_values[y * TCols + x];
+        }
+
+        // operator= --> expression template approach
+        template <typename TEXPR, typename = std::enable_if_t<IsExpression<TEXPR>>>
+        constexpr FixedMatrix& operator=(const TEXPR& expr) {
+            if constexpr (ContainsProduct<TEXPR>::value) {
+                // the product reads its factors while the result is written
+                FixedMatrix tmp{};
+                tmp.assign(expr, std::make_index_sequence<size()>{});
+                *this = tmp;
             }
             else {
-                return m_lhs(x, y) + m_rhs(x, y);
+                assign(expr, std::make_index_sequence<size()>{});
             }
+            return *this;
+        }
+
+    private:
+        // one assignment per element, no loop
+        template <typename TEXPR, size_t... Indices>
+        constexpr void assign(const TEXPR& expr, std::index_sequence<Indices...>) {
+            ((m_values[Indices] = expr(Indices % TCols, Indices / TCols)), ...);
         }
     };
 
-    template <typename LHS, typename RHS>
-    MatrixExpr<LHS, RHS> operator+(const LHS& lhs, const LHS& rhs) {
-        return MatrixExpr<LHS, RHS>(lhs, rhs);
-    }
+    template <size_t TRows, size_t TCols>
+    struct IsMatrix<FixedMatrix<TRows, TCols>> : std::true_type {};
+
+    template <size_t TRows, size_t TCols>
+    struct LayoutOf<FixedMatrix<TRows, TCols>> { using type = RowMajor; };
 
     // ========================================================================
 
@@ -174,6 +2059,8 @@ namespace ExpressionTemplates {
     {
         std::cout << "Expression Template 01: Classical Approach" << std::endl;
 
+        using Classical::operator+;
+
         Matrix a{}, b{}, c{}, d{};
 
         // initialize matrices
@@ -258,57 +2145,84 @@ namespace ExpressionTemplates {
 
     // =====================================================================================
 
-    void test_04a_benchmark(
-        int iterations,
-        Matrix& result,
-        const Matrix& a1,
-        const Matrix& a2,
-        const Matrix& a3,
-        const Matrix& a4,
-        const Matrix& a5)
+    // classical approach, hand-written loop and expression templates: a + b + c,
+    // measured by the benchmark harness for sizes from 64 x 64 up to 4096 x 4096
+    template <typename TFunction>
+    Benchmarking::Benchmark::Setup test_04_setup(TFunction&& sum)
     {
-        auto start = std::chrono::high_resolution_clock::now();
-        for (int i = 0; i < iterations; ++i) {
-            result = a1 + a2 + a3 + a4 + a5;
-        }
-        auto end = std::chrono::high_resolution_clock::now();
+        return [=](size_t size) -> Benchmarking::Benchmark::Function {
+
+            auto a{ std::make_shared<Matrix>(size, size) };
+            auto b{ std::make_shared<Matrix>(size, size) };
+            auto c{ std::make_shared<Matrix>(size, size) };
+            auto result{ std::make_shared<Matrix>(size, size) };
+
+            for (size_t y = 0; y != size; ++y) {
+                for (size_t x = 0; x != size; ++x) {
+                    (*a)(x, y) = 1.0;
+                    (*b)(x, y) = 2.0;
+                    (*c)(x, y) = 3.0;
+                }
+            }
 
-        std::cout
-            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
-            << " milliseconds." << std::endl;
+            return [=]() {
+                sum(*result, *a, *b, *c);
+                Benchmarking::doNotOptimize(result->data()[0]);
+            };
+        };
     }
 
-    void test_04b_benchmark(
-        int iterations,
-        Matrix& result,
-        const Matrix& a1,
-        const Matrix& a2,
-        const Matrix& a3,
-        const Matrix& a4,
-        const Matrix& a5)
+    void test_04_benchmark()
     {
-        // adding 5 matrices with expression template approach
-        MatrixExpr<Matrix, Matrix> sumAB{ a1, a2 };
-        MatrixExpr<MatrixExpr<Matrix, Matrix>, Matrix> sumABC{ sumAB, a3 };
-        MatrixExpr<MatrixExpr<MatrixExpr<Matrix, Matrix>, Matrix>, Matrix> sumABCD{ sumABC, a4 };
-        MatrixExpr<MatrixExpr<MatrixExpr<MatrixExpr<Matrix, Matrix>, Matrix>, Matrix>, Matrix> sumABCDE{ sumABCD, a5 };
+        Benchmarking::Benchmark benchmark{ "Expression Templates 04 (Benchmark)" };
 
-        auto start = std::chrono::high_resolution_clock::now();
-        for (int i = 0; i < iterations; ++i) {
-            result = sumABCDE;
-        }
-        auto end = std::chrono::high_resolution_clock::now();
+        // three matrices read, one written
+        auto bytes = [](size_t size) { return 4.0 * size * size * sizeof(double); };
+
+        benchmark.add("Classical operator+", test_04_setup(
+            [](Matrix& result, const Matrix& a, const Matrix& b, const Matrix& c) {
+                using Classical::operator+;
+                result = a + b + c;
+            }), bytes);
+
+        benchmark.add("add3", test_04_setup(
+            [](Matrix& result, const Matrix& a, const Matrix& b, const Matrix& c) { result = add3(a, b, c); }), bytes);
+
+        benchmark.add("Expression templates", test_04_setup(
+            [](Matrix& result, const Matrix& a, const Matrix& b, const Matrix& c) { result = a + b + c; }), bytes);
+
+        benchmark.run(Benchmarking::powersOfTwo(64, 4096));
+
+        std::ofstream csv{ "ExpressionTemplates_04.csv" };
+        benchmark.writeCsv(csv);
+
+        std::ofstream json{ "ExpressionTemplates_04.json" };
+        benchmark.writeJson(json);
 
-        std::cout
-            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
-            << " milliseconds." << std::endl;
+        std::cout << "Done." << std::endl;
     }
 
-    void test_04_benchmark()
+    // =====================================================================================
+
+    // at least 'iterations' runs, reported as median and 95th percentile of a single run
+    template <typename TFunction>
+    void test_05_measure(const std::string& label, int iterations, TFunction&& function)
+    {
+        Benchmarking::Options options{};
+        options.minRuns = iterations;
+
+        Benchmarking::Statistics statistics{ Benchmarking::measure(function, options) };
+        Benchmarking::print(std::cout, label, statistics);
+    }
+
+    void test_05_benchmark()
     {
-        std::cout << "Expression Templates 04 (Benchmark):" << std::endl;
+        std::cout << "Expression Templates 05 (SIMD Benchmark):" << std::endl;
+        std::cout << "Detected instruction set: " << toString(getInstructionSet()) << std::endl;
 
-        Matrix a{}, b{}, c{}, d{}, e{};
+        using Classical::operator+;
+
+        Matrix a{}, b{}, c{}, d{};
         Matrix result{};
 
         // initialize matrices
@@ -318,13 +2232,539 @@ namespace ExpressionTemplates {
                 b(x, y) = 2.0;
                 c(x, y) = 3.0;
                 d(x, y) = 4.0;
-                e(x, y) = 5.0;
             }
         }
 
-        std::cout << "Start:" << std::endl;
-        test_04a_benchmark(Iterations, result, a, b, c, d, e);
-        test_04b_benchmark(Iterations, result, a, b, c, d, e);
+        MatrixExpr<Matrix, Matrix> sumAB{ a, b };
+        MatrixExpr<MatrixExpr<Matrix, Matrix>, Matrix> sumABC{ sumAB, c };
+        MatrixExpr<MatrixExpr<MatrixExpr<Matrix, Matrix>, Matrix>, Matrix> sumABCD{ sumABC, d };
+
+        test_05_measure("Classical operator+    ", Iterations, [&]() {
+            result = a + b + c + d;
+        });
+
+        test_05_measure("Scalar (x, y) loop     ", Iterations, [&]() {
+            result.evaluateByIndex(sumABCD);
+        });
+
+        // run every instruction set up to the one supported by this CPU
+        InstructionSet supported{ getInstructionSet() };
+        for (InstructionSet instructionSet : { 
+            InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 }) 
+        {
+            if (instructionSet > supported) {
+                break;
+            }
+
+            std::string label{ toString(instructionSet) };
+            label.resize(23, ' ');
+            test_05_measure(label, Iterations, [&]() {
+                result.evaluate(sumABCD, instructionSet);
+            });
+        }
+
+        std::cout << "result(0, 0) = " << result(0, 0) << std::endl;
+        std::cout << "Done." << std::endl;
+    }
+
+    // =====================================================================================
+
+    void test_06_benchmark()
+    {
+        std::cout << "Expression Templates 06 (Multi-threaded Benchmark):" << std::endl;
+
+        Matrix a{}, b{}, c{}, d{};
+        Matrix serial{}, parallel{};
+
+        // initialize matrices with values that are not exactly representable
+        for (size_t y = 0; y != a.getRows(); ++y) {
+            for (size_t x = 0; x != a.getCols(); ++x) {
+                a(x, y) = 0.1 * x;
+                b(x, y) = 0.7 * y;
+                c(x, y) = 1.0 / (x + 1);
+                d(x, y) = 1.0 / (y + 3);
+            }
+        }
+
+        MatrixExpr<Matrix, Matrix> sumAB{ a, b };
+        MatrixExpr<MatrixExpr<Matrix, Matrix>, Matrix> sumABC{ sumAB, c };
+        MatrixExpr<MatrixExpr<MatrixExpr<Matrix, Matrix>, Matrix>, Matrix> sumABCD{ sumABC, d };
+
+        InstructionSet instructionSet{ getInstructionSet() };
+
+        test_05_measure("Serial      ", Iterations, [&]() {
+            serial.evaluate(sumABCD, instructionSet);
+        });
+
+        size_t maxThreads{ std::max<size_t>(1, std::thread::hardware_concurrency()) };
+        for (size_t numThreads{ 1 }; numThreads <= maxThreads; numThreads *= 2) {
+
+            ThreadPool pool{ numThreads };
+
+            std::string label{ std::to_string(numThreads) + " Thread(s)" };
+            label.resize(12, ' ');
+            test_05_measure(label, Iterations, [&]() {
+                parallel.evaluateParallel(sumABCD, instructionSet, pool);
+            });
+
+            bool identical{ std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(double)) == 0 };
+            std::cout << "    bit-identical to serial result: " << std::boolalpha << identical << std::endl;
+        }
+
+        // an exception of a task - in a worker or in the calling thread - is rethrown by 'run',
+        // the pool remains usable
+        ThreadPool pool{ 4 };
+        std::atomic<size_t> executed{};
+        for (size_t failing : { size_t{ 0 }, size_t{ 63 } }) {
+            try {
+                pool.run(64, [&](size_t task) {
+                    if (task == failing) {
+                        throw std::runtime_error{ "task " + std::to_string(task) + " failed" };
+                    }
+                });
+            }
+            catch (const std::runtime_error& ex) {
+                std::cout << "Exception: " << ex.what() << std::endl;
+            }
+        }
+        pool.run(64, [&](size_t) { ++executed; });
+        std::cout << "Tasks executed after the exceptions: " << executed << std::endl;  // 64
+
+        std::cout << "Done." << std::endl;
+    }
+
+    // =====================================================================================
+
+    void test_07()
+    {
+        std::cout << "Expression Templates 07: Subtraction, Scaling, Products and Unary Operations" << std::endl;
+
+        Matrix a{}, b{}, c{}, d{};
+        Matrix result{}, expected{};
+
+        // initialize matrices
+        for (size_t y = 0; y != a.getRows(); ++y) {
+            for (size_t x = 0; x != a.getCols(); ++x) {
+                a(x, y) = 1.0 + x;
+                b(x, y) = 2.0;
+                c(x, y) = 0.5 * y;
+                d(x, y) = 4.0 * (x + y);
+            }
+        }
+
+        // single pass, no temporary 'Matrix' object
+        test_05_measure("Expression templates", Iterations, [&]() {
+            result = 0.5 * a - b * c + sqrt(d);
+        });
+
+        // hand-written loop for comparison
+        test_05_measure("Hand-written loop   ", Iterations, [&]() {
+            for (size_t y = 0; y != a.getRows(); ++y) {
+                for (size_t x = 0; x != a.getCols(); ++x) {
+                    expected(x, y) = 0.5 * a(x, y) - b(x, y) * c(x, y) + std::sqrt(d(x, y));
+                }
+            }
+        });
+
+        double maxDifference{};
+        for (size_t i = 0; i != result.size(); ++i) {
+            maxDifference = std::max(maxDifference, std::fabs(result.data()[i] - expected.data()[i]));
+        }
+        std::cout << "max. difference: " << maxDifference << std::endl;
+
+        // further examples
+        result = -a / 2.0 + abs(c - 10.0);
+        std::cout << "result(1, 2) = " << result(1, 2) << std::endl;  // -1 + 9 = 8
+
+        result = map(a + b, [](double value) { return value * value; });
+        std::cout << "result(1, 2) = " << result(1, 2) << std::endl;  // (2 + 2)^2 = 16
+
+        // integral scalars are converted to 'double'
+        result = 2 * a + b / 4;
+        std::cout << "result(1, 2) = " << result(1, 2) << std::endl;  // 2 * 2 + 0.5 = 4.5
+
+        // expression nodes store their sub-expressions by value
+        auto expr = (a + b) * 2.0;
+        result = expr;
+        std::cout << "result(1, 2) = " << result(1, 2) << std::endl;  // (2 + 2) * 2 = 8
+    }
+    // =====================================================================================
+
+    void test_08_naive_product(Matrix& result, const Matrix& a, const Matrix& b)
+    {
+        for (size_t y = 0; y != a.getRows(); ++y) {
+            for (size_t x = 0; x != b.getCols(); ++x) {
+                double sum{};
+                for (size_t k = 0; k != a.getCols(); ++k) {
+                    sum += a(k, y) * b(x, k);
+                }
+                result(x, y) = sum;
+            }
+        }
+    }
+
+    template <typename TFunction>
+    void test_08_measure(const std::string& label, double flops, TFunction&& function)
+    {
+        // a single product takes up to a second: no warm-up, only a few runs
+        Benchmarking::Options options{};
+        options.warmupRuns = 0;
+        options.minRuns = 3;
+
+        Benchmarking::Statistics statistics{ Benchmarking::measure(function, options) };
+        std::cout << label << ": "
+            << statistics.median * 1e3 << " milliseconds (median), "
+            << flops / statistics.median / 1e9 << " GFLOP/s." << std::endl;
+    }
+
+    void test_08_benchmark()
+    {
+        std::cout << "Expression Templates 08 (Matrix Product Benchmark):" << std::endl;
+
+        Matrix a{}, b{}, c{};
+        Matrix naive{}, result{};
+
+        // initialize matrices
+        for (size_t y = 0; y != a.getRows(); ++y) {
+            for (size_t x = 0; x != a.getCols(); ++x) {
+                a(x, y) = 1.0 / (1 + x + y);
+                b(x, y) = 0.5 * x - 0.25 * y;
+                c(x, y) = 1.0;
+            }
+        }
+
+        double flops{ 2.0 * a.getRows() * a.getCols() * b.getCols() };
+
+        test_08_measure("Naive triple loop    ", flops, [&]() {
+            test_08_naive_product(naive, a, b);
+        });
+
+        InstructionSet supported{ getInstructionSet() };
+        for (InstructionSet instructionSet : {
+            InstructionSet::Scalar, InstructionSet::SSE2, InstructionSet::AVX2, InstructionSet::AVX512 })
+        {
+            if (instructionSet > supported) {
+                break;
+            }
+
+            std::string label{ "Blocked, " + toString(instructionSet) };
+            label.resize(21, ' ');
+            test_08_measure(label, flops, [&]() {
+                multiply(result, product(a, b), NoEpilogue{}, instructionSet, nullptr);
+            });
+        }
+
+        test_08_measure("Blocked, parallel    ", flops, [&]() {
+            multiply(result, product(a, b), NoEpilogue{}, supported, &getThreadPool());
+        });
+
+        double maxDifference{};
+        for (size_t i = 0; i != result.size(); ++i) {
+            maxDifference = std::max(maxDifference, std::fabs(result.data()[i] - naive.data()[i]));
+        }
+        std::cout << "max. difference to naive product: " << maxDifference << std::endl;
+
+        // addition fused into the epilogue of the kernel
+        test_08_measure("r = product(a, b) + c", flops, [&]() {
+            result = product(a, b) + c;
+        });
+
+        std::cout << "Done." << std::endl;
+    }
+    // =====================================================================================
+
+    constexpr int SmallMatrixIterations{ 1000000 };
+
+    template <typename TMatrix, typename TAllocator, typename TReset>
+    void test_09_create_small_matrices(const std::string& label, const TAllocator& allocator, TReset&& reset)
+    {
+        Benchmarking::Statistics statistics{ Benchmarking::measure([&]() {
+            for (int i = 0; i < SmallMatrixIterations; ++i) {
+                {
+                    TMatrix a{ DefaultCols, DefaultRows, allocator };
+                    TMatrix b{ DefaultCols, DefaultRows, allocator };
+                    a(1, 1) = i;
+                    b(2, 2) = 1.0;
+                    a = a + b;
+                    Benchmarking::doNotOptimize(a(1, 1));
+                }
+                reset();
+            }
+        }) };
+
+        Benchmarking::print(std::cout, label, statistics);
+    }
+
+    void test_09_benchmark()
+    {
+        std::cout << "Expression Templates 09 (Small Matrices Benchmark):" << std::endl;
+
+        // 'InlineCapacity' 0: elements always taken from the allocator
+        using HeapMatrix = BasicMatrix<std::allocator<double>, 0>;
+        using ArenaMatrix = BasicMatrix<std::pmr::polymorphic_allocator<double>, 0>;
+
+        Matrix small{ DefaultCols, DefaultRows };
+        Matrix large{};
+        std::cout << "3x3 matrix inline:     " << std::boolalpha << small.isInline() << std::endl;
+        std::cout << "Default matrix inline: " << std::boolalpha << large.isInline() << std::endl;
+        std::cout << "Alignment of elements: " 
+            << reinterpret_cast<std::uintptr_t>(large.data()) % Alignment << std::endl;
+
+        auto noReset = []() {};
+
+        test_09_create_small_matrices<HeapMatrix>("Heap (std::allocator)", std::allocator<double>{}, noReset);
+        test_09_create_small_matrices<Matrix>("Inline storage       ", Matrix::allocator_type{}, noReset);
+
+        // matrices taken from an arena on the stack, released at the end of each iteration
+        alignas(Alignment) char buffer[1024];
+        std::pmr::monotonic_buffer_resource arena{ buffer, sizeof(buffer), std::pmr::null_memory_resource() };
+        std::pmr::polymorphic_allocator<double> allocator{ &arena };
+        test_09_create_small_matrices<ArenaMatrix>("Arena (monotonic)    ", allocator, [&]() { arena.release(); });
+
+        std::cout << "Done." << std::endl;
+    }
+    // =====================================================================================
+
+    void test_10()
+    {
+        std::cout << "Expression Templates 10: FixedMatrix" << std::endl;
+
+        // expressions evaluated by the compiler
+        static constexpr FixedMatrix<2, 2> a{ 1.0, 2.0, 3.0, 4.0 };
+        static constexpr FixedMatrix<2, 2> b{ 5.0, 6.0, 7.0, 8.0 };
+
+        constexpr FixedMatrix<2, 2> c{ 0.5 * a - b + 2.0 * a * b };
+        static_assert(c(1, 1) == 58.0, "0.5 * 4 - 8 + 2 * 4 * 8 == 58");
+
+        constexpr FixedMatrix<2, 2> p{ product(a, b) + 1.0 };
+        static_assert(p(0, 0) == 20.0, "1 * 5 + 2 * 7 + 1 == 20");
+        static_assert(p(1, 1) == 51.0, "3 * 6 + 4 * 8 + 1 == 51");
+
+        std::cout << "c(1, 1) = " << c(1, 1) << ", p(0, 0) = " << p(0, 0) << std::endl;
+
+        // at runtime: 4x4 transformation matrices
+        FixedMatrix<4, 4> rotate{
+            0.0, -1.0, 0.0, 0.0,
+            1.0,  0.0, 0.0, 0.0,
+            0.0,  0.0, 1.0, 0.0,
+            0.0,  0.0, 0.0, 1.0
+        };
+
+        FixedMatrix<4, 4> transform{
+            1.0, 0.0, 0.0, 0.0,
+            0.0, 1.0, 0.0, 0.0,
+            0.0, 0.0, 1.0, 0.0,
+            0.0, 0.0, 0.0, 1.0
+        };
+
+        for (int i = 0; i != 4; ++i) {
+            transform = product(rotate, transform);  // 4 x 90 degrees
+        }
+        std::cout << "transform(0, 0) = " << transform(0, 0) << std::endl;  // 1
+    }
+
+    constexpr int SmallUpdateIterations{ 10000000 };
+
+    template <typename TMatrix>
+    void test_10_small_updates(const std::string& label, TMatrix a, TMatrix b, TMatrix result)
+    {
+        Benchmarking::Statistics statistics{ Benchmarking::measure([&]() {
+            for (int i = 0; i < SmallUpdateIterations; ++i) {
+                a(0, 0) = i;
+                result = 0.5 * a + b - result;
+            }
+            Benchmarking::doNotOptimize(result);
+        }) };
+
+        Benchmarking::print(std::cout, label, statistics);
+    }
+
+    void test_10_benchmark()
+    {
+        std::cout << "Expression Templates 10 (FixedMatrix Benchmark):" << std::endl;
+
+        test_10_small_updates("Matrix 3x3        ", Matrix{ 3, 3 }, Matrix{ 3, 3 }, Matrix{ 3, 3 });
+        test_10_small_updates("FixedMatrix<3, 3> ", FixedMatrix<3, 3>{}, FixedMatrix<3, 3>{}, FixedMatrix<3, 3>{});
+        test_10_small_updates("Matrix 4x4        ", Matrix{ 4, 4 }, Matrix{ 4, 4 }, Matrix{ 4, 4 });
+        test_10_small_updates("FixedMatrix<4, 4> ", FixedMatrix<4, 4>{}, FixedMatrix<4, 4>{}, FixedMatrix<4, 4>{});
+
+        std::cout << "Done." << std::endl;
+    }
+    // =====================================================================================
+
+    void test_11()
+    {
+        std::cout << "Expression Templates 11: Reductions" << std::endl;
+
+        Matrix a{ 2, 2 }, b{ 2, 2 };
+        a(0, 0) = 1.0;  a(1, 0) = 2.0;
+        a(0, 1) = 3.0;  a(1, 1) = 4.0;
+        b(0, 0) = 2.0;  b(1, 0) = -1.0;
+        b(0, 1) = 0.5;  b(1, 1) = 1.0;
+
+        std::cout << "sum(a + b)     = " << sum(a + b) << std::endl;          // 12.5
+        std::cout << "norm(a)        = " << norm(a) << std::endl;             // sqrt(30)
+        std::cout << "dot(a, b)      = " << dot(a, b) << std::endl;           // 5.5
+        std::cout << "minimum(a - b) = " << minimum(a - b) << std::endl;      // -1
+        std::cout << "maximum(a - b) = " << maximum(a - b) << std::endl;      // 3
+
+        // compensated summation
+        Matrix tenths{};
+        std::fill(tenths.data(), tenths.data() + tenths.size(), 0.1);
+
+        double naive{};
+        for (size_t i{}; i != tenths.size(); ++i) {
+            naive += tenths.data()[i];
+        }
+
+        std::cout.precision(17);
+        std::cout << "Exact:          " << 0.1 * tenths.size() << std::endl;
+        std::cout << "Naive loop:     " << naive << std::endl;
+        std::cout << "sum(tenths):    " << sum(tenths) << std::endl;
+        std::cout << "With pool:      " << sum(tenths, &getThreadPool()) << std::endl;
+        std::cout.precision(6);
+    }
+
+    void test_11_benchmark()
+    {
+        std::cout << "Expression Templates 11 (Reductions Benchmark):" << std::endl;
+
+        Matrix a{}, b{}, c{}, temp{};
+        for (size_t y = 0; y != a.getRows(); ++y) {
+            for (size_t x = 0; x != a.getCols(); ++x) {
+                a(x, y) = 0.1 * x;
+                b(x, y) = 0.7 * y;
+                c(x, y) = 1.0 / (x + 1);
+            }
+        }
+
+        double result{};
+
+        test_05_measure("Temporary + loop", Iterations, [&]() {
+            temp = a + b * c;
+            result = 0.0;
+            for (size_t i{}; i != temp.size(); ++i) {
+                result += temp.data()[i];
+            }
+        });
+        std::cout << "    sum = " << result << std::endl;
+
+        test_05_measure("sum(a + b * c)  ", Iterations, [&]() {
+            result = sum(a + b * c);
+        });
+        std::cout << "    sum = " << result << std::endl;
+
+        test_05_measure("Parallel        ", Iterations, [&]() {
+            result = sum(a + b * c, &getThreadPool());
+        });
+        std::cout << "    sum = " << result << std::endl;
+
+        test_05_measure("norm(a - b)     ", Iterations, [&]() {
+            result = norm(a - b, &getThreadPool());
+        });
+        std::cout << "    norm = " << result << std::endl;
+
+        std::cout << "Done." << std::endl;
+    }
+    // =====================================================================================
+
+    void test_12()
+    {
+        std::cout << "Expression Templates 12: Layouts and Transposed Views" << std::endl;
+
+        Matrix a{ 3, 2 };           // 3 columns, 2 rows
+        ColMajorMatrix b{ 3, 2 };
+        for (size_t y = 0; y != a.getRows(); ++y) {
+            for (size_t x = 0; x != a.getCols(); ++x) {
+                a(x, y) = 10.0 * y + x;
+                b(x, y) = 10.0 * y + x;
+            }
+        }
+
+        // same elements, different storage order
+        std::cout << "Row-major:    ";
+        std::for_each(a.data(), a.data() + a.size(), [](double value) { std::cout << value << ' '; });
+        std::cout << std::endl << "Column-major: ";
+        std::for_each(b.data(), b.data() + b.size(), [](double value) { std::cout << value << ' '; });
+        std::cout << std::endl;
+
+        Matrix t{ 2, 3 };
+        t = transpose(a);           // different layouts: blocked evaluation
+
+        ColMajorMatrix u{ 2, 3 };
+        u = transpose(a);           // same layout: linear copy of 'a'
+
+        Matrix c{ 3, 2 };
+        c = a + b;                  // mixed layouts
+
+        std::cout << "t(1, 2) = " << t(1, 2) << ", u(1, 2) = " << u(1, 2)
+            << ", c(2, 1) = " << c(2, 1) << std::endl;  // 12, 12, 24
+
+        std::cout << "sum(a + transpose(t)) = " << sum(a + transpose(t)) << std::endl;  // 2 * 36
+
+        // destination and transposed operand share their elements: regression test
+        constexpr size_t Size{ 40 };
+        Matrix s{ Size, Size };
+        for (size_t y = 0; y != s.getRows(); ++y) {
+            for (size_t x = 0; x != s.getCols(); ++x) {
+                s(x, y) = 100.0 * y + x;
+            }
+        }
+
+        Matrix original{ s };
+        s = transpose(s);
+        Matrix symmetric{ Size, Size };
+        symmetric = original;
+        symmetric = symmetric + transpose(symmetric);
+
+        size_t wrong{};
+        for (size_t y = 0; y != s.getRows(); ++y) {
+            for (size_t x = 0; x != s.getCols(); ++x) {
+                if (s(x, y) != original(y, x)) ++wrong;
+                if (symmetric(x, y) != original(x, y) + original(y, x)) ++wrong;
+            }
+        }
+
+        std::cout << "s = transpose(s), s = s + transpose(s): "
+            << (wrong == 0 ? "ok" : "FAILED - " + std::to_string(wrong) + " wrong elements") << std::endl;
+    }
+
+    void test_12_benchmark()
+    {
+        std::cout << "Expression Templates 12 (Transposed Views Benchmark):" << std::endl;
+
+        // a power of two: the strided reads of the naive loop collide in the cache
+        constexpr size_t Size{ 2048 };
+
+        Matrix a{ Size, Size }, b{ Size, Size }, result{ Size, Size };
+        ColMajorMatrix colMajorResult{ Size, Size };
+        for (size_t y = 0; y != a.getRows(); ++y) {
+            for (size_t x = 0; x != a.getCols(); ++x) {
+                a(x, y) = 0.1 * x;
+                b(x, y) = 0.7 * y;
+            }
+        }
+
+        test_05_measure("a + b                  ", Iterations, [&]() {
+            result = a + b;
+        });
+
+        test_05_measure("a + transpose(b), naive", Iterations, [&]() {
+            result.evaluateByIndex(a + transpose(b));
+        });
+
+        test_05_measure("a + transpose(b), block", Iterations, [&]() {
+            result.evaluateBlocked(a + transpose(b), nullptr);
+        });
+
+        test_05_measure("a + transpose(b)       ", Iterations, [&]() {
+            result = a + transpose(b);   // blocked and parallel
+        });
+
+        test_05_measure("col-major transpose(b) ", Iterations, [&]() {
+            colMajorResult = transpose(b);
+        });
+
         std::cout << "Done." << std::endl;
     }
 }
@@ -336,6 +2776,17 @@ void main_expression_templates()
     test_02();            // <== expression templates approach
     test_03();            // <== expression templates approach using modified operator=
     test_04_benchmark();  // <== benchmark
+    test_05_benchmark();  // <== benchmark: SIMD evaluation
+    test_06_benchmark();  // <== benchmark: multi-threaded evaluation
+    test_07();            // <== subtraction, scalars, element-wise product, unary operations
+    test_08_benchmark();  // <== benchmark: matrix product
+    test_09_benchmark();  // <== benchmark: creating small matrices
+    test_10();            // <== matrices with compile-time dimensions
+    test_10_benchmark();  // <== benchmark: small matrix updates
+    test_11();            // <== reductions
+    test_11_benchmark();  // <== benchmark: reductions without temporaries
+    test_12();            // <== row-major and column-major layouts, transposed views
+    test_12_benchmark();  // <== benchmark: transposed operands
 }
 
 // =====================================================================================
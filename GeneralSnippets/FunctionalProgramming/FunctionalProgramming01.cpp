@@ -3,14 +3,32 @@
 // =====================================================================================
 
 #include <iostream>
+#include <fstream>
 #include <string>
+#include <string_view>
 #include <algorithm>
 #include <numeric>
 #include <iterator>
+#include <cmath>
 #include <type_traits>
 #include <vector>
 #include <list>
 #include <sstream>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "../Global/Benchmark.h"
 
 namespace FunctionalProgramming_01 {
 
@@ -31,13 +49,24 @@ namespace FunctionalProgramming_01 {
     template <typename T>
     using ValueType = typename std::iterator_traits<T>::value_type;
 
+    // std::distance would consume a single-pass range (e.g. std::istream_iterator)
+    template <typename TVector, typename InputIterator>
+    void reserveFor(TVector& result, InputIterator begin, InputIterator end)
+    {
+        using Category = typename std::iterator_traits<InputIterator>::iterator_category;
+
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+            result.reserve(std::distance(begin, end));
+        }
+    }
+
     template <typename InputIterator, typename TFunctor>
     auto filter(InputIterator begin, InputIterator end, TFunctor&& lambda)
         // not needed, just for demonstration purposes
         -> std::vector<ValueType<InputIterator>>
     {
         std::vector<ValueType<InputIterator>> result;
-        result.reserve(std::distance(begin, end));
+        reserveFor(result, begin, end);
         std::copy_if(begin, end, std::back_inserter(result), std::forward<TFunctor>(lambda));
         return result;
     }
@@ -51,7 +80,7 @@ namespace FunctionalProgramming_01 {
         using ValueType = typename std::iterator_traits<InputIterator>::value_type;
 
         std::vector<ValueType> result;
-        result.reserve(std::distance(begin, end));
+        reserveFor(result, begin, end);
         std::copy_if(begin, end, std::back_inserter(result), std::forward<TFunctor>(lambda));
         return result;
     }
@@ -66,7 +95,7 @@ namespace FunctionalProgramming_01 {
         using FunctorValueType = decltype(std::declval<TFunctor>()(std::declval<ValueType<InputIterator>>()));
 
         std::vector<FunctorValueType> result;
-        result.reserve(std::distance(begin, end));
+        reserveFor(result, begin, end);
         std::transform(begin, end, std::back_inserter(result), std::forward<TFunctor>(lambda));
         return result;
     }
@@ -81,11 +110,549 @@ namespace FunctionalProgramming_01 {
         using FunctorValueType = decltype(std::declval<TFunctor>()(std::declval<ValueType>()));
 
         std::vector<FunctorValueType> result;
-        result.reserve(std::distance(begin, end));
+        reserveFor(result, begin, end);
         std::transform(begin, end, std::back_inserter(result), std::forward<TFunctor>(lambda));
         return result;
     }
 
+    // =================================================================================
+    // streaming: a single pass over input iterators in constant memory
+
+    // the accumulator is moved from step to step, 'begin' and 'end' may be input iterators
+    template <typename InputIterator, typename TResult, typename TFunctor>
+    TResult fold(InputIterator begin, InputIterator end, TResult init, TFunctor&& lambda)
+    {
+        for (; begin != end; ++begin) {
+            init = lambda(std::move(init), *begin);
+        }
+        return init;
+    }
+
+    // higher-order functions on reducing functions '(accumulator, element) => accumulator':
+    // filtering(predicate)(reducer) skips elements, mapping(functor)(reducer) transforms them,
+    // no element is stored in between
+    template <typename TPredicate>
+    auto filtering(TPredicate predicate)
+    {
+        return [=](auto reducer) {
+            return [=](auto accumulator, auto&& element) -> decltype(accumulator) {
+                if (predicate(element)) {
+                    return reducer(std::move(accumulator), std::forward<decltype(element)>(element));
+                }
+                return accumulator;
+            };
+        };
+    }
+
+    template <typename TFunctor>
+    auto mapping(TFunctor functor)
+    {
+        return [=](auto reducer) {
+            return [=](auto accumulator, auto&& element) {
+                return reducer(std::move(accumulator), functor(std::forward<decltype(element)>(element)));
+            };
+        };
+    }
+
+    // pipe(t1, t2, t3)(reducer) == t1(t2(t3(reducer))): every element passes t1 first
+    template <typename TTransform>
+    auto pipe(TTransform transform)
+    {
+        return transform;
+    }
+
+    template <typename TTransform, typename... TTransforms>
+    auto pipe(TTransform transform, TTransforms... transforms)
+    {
+        return [=](auto reducer) { return transform(pipe(transforms...)(reducer)); };
+    }
+
+    // buffered line reader: the file is read in large blocks, a line is a
+    // std::string_view into the buffer and valid until the iterator is advanced
+    class LineReader
+    {
+    private:
+        std::ifstream m_file;
+        std::vector<char> m_buffer;
+        size_t m_pos;             // start of the next line
+        size_t m_end;             // end of the data in the buffer
+        size_t m_bytesRead;
+        bool m_eof;
+        std::string_view m_line;
+
+    public:
+        static constexpr size_t DefaultBufferSize{ 1 << 20 };
+
+        class Iterator
+        {
+        private:
+            LineReader* m_reader;  // nullptr: end of file
+
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const std::string_view*;
+            using reference = const std::string_view&;
+
+            Iterator() : m_reader{ nullptr } {}
+            explicit Iterator(LineReader* reader) : m_reader{ reader } { advance(); }
+
+            reference operator* () const { return m_reader->m_line; }
+            pointer operator-> () const { return &m_reader->m_line; }
+
+            Iterator& operator++ () { advance(); return *this; }
+
+            friend bool operator== (const Iterator& lhs, const Iterator& rhs) { return lhs.m_reader == rhs.m_reader; }
+            friend bool operator!= (const Iterator& lhs, const Iterator& rhs) { return lhs.m_reader != rhs.m_reader; }
+
+        private:
+            void advance() {
+                if (!m_reader->next()) {
+                    m_reader = nullptr;
+                }
+            }
+        };
+
+        // c'tor
+        explicit LineReader(const std::filesystem::path& path, size_t bufferSize = DefaultBufferSize);
+
+        // getter
+        bool isOpen() const { return m_file.is_open(); }
+        size_t bytesRead() const { return m_bytesRead; }
+
+        // single pass: 'begin' reads the first line
+        Iterator begin() { return Iterator{ this }; }
+        Iterator end() { return Iterator{}; }
+
+    private:
+        bool next();
+    };
+
+    LineReader::LineReader(const std::filesystem::path& path, size_t bufferSize)
+        : m_file{ path, std::ios::binary }, m_buffer(std::max<size_t>(bufferSize, 1)), 
+          m_pos{}, m_end{}, m_bytesRead{}, m_eof{ !m_file.is_open() } {}
+
+    bool LineReader::next()
+    {
+        while (true) {
+            const char* data{ m_buffer.data() };
+            const void* newline{ std::memchr(data + m_pos, '\n', m_end - m_pos) };
+
+            size_t lineEnd{};
+            size_t nextPos{};
+            if (newline != nullptr) {
+                lineEnd = static_cast<const char*>(newline) - data;
+                nextPos = lineEnd + 1;
+            }
+            else if (m_eof) {
+                if (m_pos == m_end) {
+                    return false;
+                }
+                lineEnd = nextPos = m_end;  // last line without '\n'
+            }
+            else {
+                // keep the incomplete line, a line longer than the buffer enlarges it
+                size_t rest{ m_end - m_pos };
+                std::memmove(m_buffer.data(), m_buffer.data() + m_pos, rest);
+                m_pos = 0;
+                m_end = rest;
+                if (m_end == m_buffer.size()) {
+                    m_buffer.resize(2 * m_buffer.size());
+                }
+
+                m_file.read(m_buffer.data() + m_end, static_cast<std::streamsize>(m_buffer.size() - m_end));
+                size_t count{ static_cast<size_t>(m_file.gcount()) };
+                m_end += count;
+                m_bytesRead += count;
+                m_eof = (count == 0);
+                continue;
+            }
+
+            // "\r\n" line endings
+            size_t length{ lineEnd - m_pos };
+            if (length != 0 && data[lineEnd - 1] == '\r') {
+                --length;
+            }
+
+            m_line = std::string_view{ data + m_pos, length };
+            m_pos = nextPos;
+            return true;
+        }
+    }
+
+    // =================================================================================
+    // work-stealing thread pool:
+    // every worker owns a deque of tasks. New tasks are pushed at its back and
+    // taken from there again (LIFO, cache-friendly), idle workers steal the oldest
+    // tasks from the front of the other deques
+
+    class WorkStealingPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+    private:
+        struct Queue {
+            std::deque<Task> m_tasks;
+            std::mutex m_mutex;
+        };
+
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_workers;
+        std::atomic<size_t> m_queuedTasks;
+        std::atomic<size_t> m_nextQueue;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wakeUp;
+        bool m_shutdown;
+
+        // index of the queue owned by the current thread, if it is a worker of this pool
+        static inline thread_local const WorkStealingPool* t_pool{ nullptr };
+        static inline thread_local size_t t_queue{};
+
+    public:
+        explicit WorkStealingPool(size_t numThreads)
+            : m_queuedTasks{}, m_nextQueue{}, m_shutdown{ false }
+        {
+            numThreads = std::max<size_t>(1, numThreads);
+            for (size_t i{}; i != numThreads; ++i) {
+                m_queues.push_back(std::make_unique<Queue>());
+            }
+            for (size_t i{}; i != numThreads; ++i) {
+                m_workers.emplace_back([this, i]() { workerLoop(i); });
+            }
+        }
+
+        ~WorkStealingPool()
+        {
+            {
+                std::lock_guard<std::mutex> guard{ m_sleepMutex };
+                m_shutdown = true;
+            }
+            m_wakeUp.notify_all();
+            for (std::thread& worker : m_workers) {
+                worker.join();
+            }
+        }
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+        // getter
+        size_t size() const { return m_workers.size(); }
+
+        // workers push to their own deque, other threads distribute round robin
+        void submit(Task task)
+        {
+            size_t index{ (t_pool == this) ? t_queue : m_nextQueue++ % m_queues.size() };
+            {
+                Queue& queue{ *m_queues[index] };
+                std::lock_guard<std::mutex> guard{ queue.m_mutex };
+                queue.m_tasks.push_back(std::move(task));
+            }
+            {
+                std::lock_guard<std::mutex> guard{ m_sleepMutex };
+                ++m_queuedTasks;
+            }
+            m_wakeUp.notify_one();
+        }
+
+        // executes one pending task, returns false if there was none -
+        // used by threads waiting for their tasks to complete
+        bool runPendingTask()
+        {
+            Task task{};
+            if (!tryPop(task)) {
+                return false;
+            }
+            task();
+            return true;
+        }
+
+    private:
+        bool tryPop(Task& task)
+        {
+            size_t numQueues{ m_queues.size() };
+            size_t own{ (t_pool == this) ? t_queue : numQueues };
+
+            // own deque: newest task
+            if (own != numQueues) {
+                Queue& queue{ *m_queues[own] };
+                std::lock_guard<std::mutex> guard{ queue.m_mutex };
+                if (!queue.m_tasks.empty()) {
+                    task = std::move(queue.m_tasks.back());
+                    queue.m_tasks.pop_back();
+                    --m_queuedTasks;
+                    return true;
+                }
+            }
+
+            // steal the oldest task of another deque
+            size_t start{ (own != numQueues) ? own + 1 : 0 };
+            for (size_t i{}; i != numQueues; ++i) {
+                size_t index{ (start + i) % numQueues };
+                if (index == own) {
+                    continue;
+                }
+                Queue& queue{ *m_queues[index] };
+                std::lock_guard<std::mutex> guard{ queue.m_mutex };
+                if (!queue.m_tasks.empty()) {
+                    task = std::move(queue.m_tasks.front());
+                    queue.m_tasks.pop_front();
+                    --m_queuedTasks;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void workerLoop(size_t index)
+        {
+            t_pool = this;
+            t_queue = index;
+
+            while (true) {
+                if (runPendingTask()) {
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock{ m_sleepMutex };
+                m_wakeUp.wait(lock, [this]() { return m_shutdown || m_queuedTasks != 0; });
+                if (m_shutdown) {
+                    return;
+                }
+            }
+        }
+    };
+
+    // default pool, one worker per hardware thread
+    WorkStealingPool& getWorkStealingPool()
+    {
+        static WorkStealingPool pool{ std::thread::hardware_concurrency() };
+        return pool;
+    }
+
+    // a set of tasks to wait for: the waiting thread executes pending tasks
+    // in the meantime, so tasks may spawn and wait for tasks of their own
+    class TaskGroup
+    {
+    private:
+        WorkStealingPool& m_pool;
+        std::atomic<size_t> m_pending;
+        std::exception_ptr m_exception;
+        std::mutex m_mutex;
+        std::condition_variable m_done;
+
+    public:
+        explicit TaskGroup(WorkStealingPool& pool) : m_pool{ pool }, m_pending{} {}
+
+        ~TaskGroup() { 
+            waitForTasks(); 
+        }
+
+        template <typename TFunctor>
+        void run(TFunctor&& functor)
+        {
+            ++m_pending;
+            m_pool.submit([this, functor = std::forward<TFunctor>(functor)]() mutable {
+                try {
+                    functor();
+                }
+                catch (...) {
+                    std::lock_guard<std::mutex> guard{ m_mutex };
+                    if (!m_exception) {
+                        m_exception = std::current_exception();
+                    }
+                }
+
+                std::lock_guard<std::mutex> guard{ m_mutex };
+                if (--m_pending == 0) {
+                    m_done.notify_all();
+                }
+            });
+        }
+
+        // rethrows the first exception thrown by one of the tasks
+        void wait()
+        {
+            waitForTasks();
+            if (m_exception) {
+                std::rethrow_exception(std::exchange(m_exception, nullptr));
+            }
+        }
+
+    private:
+        void waitForTasks()
+        {
+            while (m_pending != 0) {
+                if (m_pool.runPendingTask()) {
+                    continue;
+                }
+
+                // nothing to help with: sleep instead of spinning, but look
+                // for new tasks from time to time
+                std::unique_lock<std::mutex> lock{ m_mutex };
+                m_done.wait_for(lock, std::chrono::microseconds{ 100 }, [this]() { return m_pending == 0; });
+            }
+
+            // the last task may still hold the mutex
+            std::lock_guard<std::mutex> guard{ m_mutex };
+        }
+    };
+
+    // =================================================================================
+    // parallel variants of 'map', 'filter' and 'fold', selected by the tag 'parallel'
+    // (similar to the execution policies of the STL). All of them require random access
+    // iterators, the functors are called concurrently and must be thread-safe
+
+    struct ParallelPolicy {
+        WorkStealingPool* m_pool{ nullptr };  // nullptr: default pool
+
+        WorkStealingPool& pool() const { return m_pool ? *m_pool : getWorkStealingPool(); }
+    };
+
+    constexpr ParallelPolicy parallel{};
+
+    constexpr size_t MinChunkSize{ 4096 };
+
+    // splits [0, size) into chunks - a few more than threads, for load balancing
+    inline size_t chunkSizeOf(const ParallelPolicy& policy, size_t size)
+    {
+        return std::max(MinChunkSize, size / (4 * policy.pool().size()) + 1);
+    }
+
+    template <typename TFunctor>
+    void forEachChunk(const ParallelPolicy& policy, size_t size, TFunctor&& body)
+    {
+        size_t chunkSize{ chunkSizeOf(policy, size) };
+        size_t numChunks{ (size + chunkSize - 1) / chunkSize };
+
+        TaskGroup group{ policy.pool() };
+        for (size_t chunk{ 1 }; chunk < numChunks; ++chunk) {
+            group.run([&, chunk]() {
+                body(chunk, chunk * chunkSize, std::min(size, (chunk + 1) * chunkSize));
+            });
+        }
+        if (numChunks != 0) {
+            body(0, 0, std::min(size, chunkSize));
+        }
+        group.wait();
+    }
+
+    // the chunks may write into a pre-sized result: its elements can be default
+    // constructed and are separate objects - unlike std::vector<bool>, which packs
+    // neighbouring elements into one word (a data race between the chunks)
+    template <typename T>
+    constexpr bool IsWritableByChunks = std::is_default_constructible_v<T> && !std::is_same_v<T, bool>;
+
+    // otherwise every chunk fills a buffer of its own, the buffers are concatenated in order
+    template <typename T>
+    std::vector<T> concatenate(std::vector<std::vector<T>>&& buffers)
+    {
+        if (buffers.size() == 1) {
+            return std::move(buffers.front());
+        }
+
+        size_t total{};
+        for (const auto& buffer : buffers) {
+            total += buffer.size();
+        }
+
+        std::vector<T> result;
+        result.reserve(total);
+        for (auto& buffer : buffers) {
+            result.insert(std::end(result), std::make_move_iterator(std::begin(buffer)), std::make_move_iterator(std::end(buffer)));
+        }
+        return result;
+    }
+
+    template <typename RandomIterator, typename TFunctor>
+    auto map(const ParallelPolicy& policy, RandomIterator begin, RandomIterator end, TFunctor&& lambda)
+        -> std::vector<decltype(std::declval<TFunctor>()(std::declval<ValueType<RandomIterator>>()))>
+    {
+        using FunctorValueType = decltype(std::declval<TFunctor>()(std::declval<ValueType<RandomIterator>>()));
+
+        size_t size{ static_cast<size_t>(std::distance(begin, end)) };
+
+        if constexpr (IsWritableByChunks<FunctorValueType>) {
+            std::vector<FunctorValueType> result(size);
+
+            forEachChunk(policy, size, [&](size_t, size_t first, size_t last) {
+                std::transform(begin + first, begin + last, std::begin(result) + first, lambda);
+            });
+
+            return result;
+        }
+        else {
+            size_t chunkSize{ chunkSizeOf(policy, size) };
+            std::vector<std::vector<FunctorValueType>> buffers((size + chunkSize - 1) / chunkSize);
+
+            forEachChunk(policy, size, [&](size_t chunk, size_t first, size_t last) {
+                std::vector<FunctorValueType>& buffer{ buffers[chunk] };
+                buffer.reserve(last - first);
+                std::transform(begin + first, begin + last, std::back_inserter(buffer), lambda);
+            });
+
+            return concatenate(std::move(buffers));
+        }
+    }
+
+    // order-preserving: every chunk collects its matches, the predicate
+    // is called once per element, the chunks are concatenated in order
+    template <typename RandomIterator, typename TFunctor>
+    auto filter(const ParallelPolicy& policy, RandomIterator begin, RandomIterator end, TFunctor&& lambda)
+        -> std::vector<ValueType<RandomIterator>>
+    {
+        size_t size{ static_cast<size_t>(std::distance(begin, end)) };
+        size_t chunkSize{ chunkSizeOf(policy, size) };
+        std::vector<std::vector<ValueType<RandomIterator>>> buffers((size + chunkSize - 1) / chunkSize);
+
+        forEachChunk(policy, size, [&](size_t chunk, size_t first, size_t last) {
+            std::copy_if(begin + first, begin + last, std::back_inserter(buffers[chunk]), lambda);
+        });
+
+        return concatenate(std::move(buffers));
+    }
+
+    // tree reduction: contract - 'combine' must be associative and 'identity' must be
+    // its neutral element. The order of the elements is preserved, so 'combine' need
+    // not be commutative (e.g. string concatenation). A right fold is obtained with
+    // reverse iterators. 'combine' is called with (TResult, element) inside of a chunk
+    // and with (TResult, TResult) when partial results are merged
+    template <typename RandomIterator, typename TResult, typename TFunctor>
+    TResult foldRange(WorkStealingPool& pool, RandomIterator begin, RandomIterator end,
+        const TResult& identity, const TFunctor& combine, size_t grainSize)
+    {
+        size_t size{ static_cast<size_t>(std::distance(begin, end)) };
+        if (size <= grainSize) {
+            return std::accumulate(begin, end, identity, combine);
+        }
+
+        // the left half is offered to other workers, the right half is done here
+        RandomIterator middle{ begin + size / 2 };
+        TResult left{ identity };
+
+        TaskGroup group{ pool };
+        group.run([&]() { 
+            left = foldRange(pool, begin, middle, identity, combine, grainSize);
+        });
+        TResult right{ foldRange(pool, middle, end, identity, combine, grainSize) };
+        group.wait();
+
+        return combine(std::move(left), std::move(right));
+    }
+
+    template <typename RandomIterator, typename TResult, typename TFunctor>
+    TResult fold(const ParallelPolicy& policy, RandomIterator begin, RandomIterator end,
+        const TResult& identity, const TFunctor& combine)
+    {
+        WorkStealingPool& pool{ policy.pool() };
+        size_t size{ static_cast<size_t>(std::distance(begin, end)) };
+        size_t grainSize{ std::max(MinChunkSize, size / (8 * pool.size()) + 1) };
+
+        return foldRange(pool, begin, end, identity, combine, grainSize);
+    }
+
     // =================================================================================
     // testing 'filter'
 
@@ -481,6 +1048,267 @@ namespace FunctionalProgramming_01 {
 
         std::cout << result3 << std::endl;
     }
+    // =================================================================================
+    // testing parallel 'map', 'filter' and 'fold'
+
+    void test_functional_parallel_05a()
+    {
+        std::vector<int> numbers(100000);
+        std::iota(std::begin(numbers), std::end(numbers), 1);
+
+        std::vector<long long> squares = map(
+            parallel,
+            std::begin(numbers),
+            std::end(numbers),
+            [](int n) { return static_cast<long long>(n) * n; }
+        );
+
+        std::vector<long long> even = filter(
+            parallel,
+            std::begin(squares),
+            std::end(squares),
+            [](long long n) { return n % 2 == 0; }
+        );
+
+        long long sum = fold(
+            parallel,
+            std::begin(even),
+            std::end(even),
+            0LL,
+            std::plus<>{}
+        );
+
+        std::cout << "squares: " << squares.size() << ", even: " << even.size()
+            << ", first: " << even.front() << ", last: " << even.back() << ", sum: " << sum << std::endl;
+
+        // 'bool' results are packed into words (std::vector<bool>),
+        // a result type does not need a default c'tor
+        struct Number {
+            explicit Number(int value) : m_value{ value } {}
+            int m_value;
+        };
+
+        std::vector<bool> isEven = map(parallel, std::begin(numbers), std::end(numbers), [](int n) { return n % 2 == 0; });
+        std::vector<Number> wrapped = map(parallel, std::begin(numbers), std::end(numbers), [](int n) { return Number{ n }; });
+
+        std::cout << "even flags: " << std::count(std::begin(isEven), std::end(isEven), true)
+            << ", wrapped: " << wrapped.size() << ", last: " << wrapped.back().m_value << std::endl;  // 50000, 100000, 100000
+
+        // the order is kept - a non-commutative, but associative operation
+        std::vector<std::string> words(20000, "ab");
+        std::string left = fold(parallel, std::begin(words), std::end(words), std::string{}, std::plus<>{});
+        std::string right = fold(parallel, std::rbegin(words), std::rend(words), std::string{}, std::plus<>{});
+        std::cout << "length: " << left.size() << ", starts with: " << left.substr(0, 6)
+            << ", left == right: " << std::boolalpha << (left == right) << std::endl;
+    }
+
+    constexpr size_t ParallelElements{ 20000000 };
+
+    void test_functional_parallel_05_benchmark()
+    {
+        std::cout << "Parallel map/filter/fold (" << ParallelElements << " elements):" << std::endl;
+
+        std::vector<double> values(ParallelElements);
+        std::iota(std::begin(values), std::end(values), 0.0);
+
+        auto transform = [](double value) { return std::sqrt(value) * 0.5 + 1.0; };
+        auto predicate = [](double value) { return static_cast<long long>(value) % 3 == 0; };
+
+        Benchmarking::Options options{};
+        options.minRuns = 3;
+
+        Benchmarking::print(std::cout, "Sequential map", Benchmarking::measure([&]() {
+            Benchmarking::doNotOptimize(map(std::begin(values), std::end(values), transform));
+        }, options));
+
+        Benchmarking::print(std::cout, "Sequential filter", Benchmarking::measure([&]() {
+            Benchmarking::doNotOptimize(filter(std::begin(values), std::end(values), predicate));
+        }, options));
+
+        Benchmarking::print(std::cout, "Sequential fold", Benchmarking::measure([&]() {
+            Benchmarking::doNotOptimize(fold<double>(std::begin(values), std::end(values), std::plus<>{}));
+        }, options));
+
+        size_t maxThreads{ std::max<size_t>(1, std::thread::hardware_concurrency()) };
+        for (size_t numThreads{ 1 }; numThreads <= maxThreads; numThreads *= 2) {
+
+            WorkStealingPool pool{ numThreads };
+            ParallelPolicy policy{ &pool };
+            std::string threads{ " (" + std::to_string(numThreads) + " threads)" };
+
+            Benchmarking::print(std::cout, "Parallel map" + threads, Benchmarking::measure([&]() {
+                Benchmarking::doNotOptimize(map(policy, std::begin(values), std::end(values), transform));
+            }, options));
+
+            Benchmarking::print(std::cout, "Parallel filter" + threads, Benchmarking::measure([&]() {
+                Benchmarking::doNotOptimize(filter(policy, std::begin(values), std::end(values), predicate));
+            }, options));
+
+            Benchmarking::print(std::cout, "Parallel fold" + threads, Benchmarking::measure([&]() {
+                Benchmarking::doNotOptimize(fold(policy, std::begin(values), std::end(values), 0.0, std::plus<>{}));
+            }, options));
+        }
+    }
+    // =================================================================================
+    // testing streaming folds
+
+    // a record of a file: "title;author;year;price", the strings refer to the current line
+    struct BookRecord {
+        std::string_view m_title;
+        std::string_view m_author;
+        int m_year;
+        double m_price;
+    };
+
+    // parsed incrementally, one line at a time
+    BookRecord parseBookRecord(std::string_view line)
+    {
+        BookRecord record{};
+
+        auto field = [&]() {
+            size_t pos{ line.find(';') };
+            std::string_view result{ line.substr(0, pos) };
+            line.remove_prefix(pos == std::string_view::npos ? line.size() : pos + 1);
+            return result;
+        };
+
+        record.m_title = field();
+        record.m_author = field();
+
+        std::string_view year{ field() };
+        std::from_chars(year.data(), year.data() + year.size(), record.m_year);
+
+        std::string_view price{ field() };
+        std::from_chars(price.data(), price.data() + price.size(), record.m_price);
+
+        return record;
+    }
+
+    void test_functional_streaming_06a()
+    {
+        // input iterators: every value is read exactly once
+        std::istringstream numbers{ "1 2 3 4 5 6 7 8 9 10" };
+
+        auto sumOfEvenSquares = pipe(
+            filtering([](int n) { return n % 2 == 0; }),
+            mapping([](int n) { return n * n; })
+        )(std::plus<>{});
+
+        int sum = fold(
+            std::istream_iterator<int>{ numbers },
+            std::istream_iterator<int>{},
+            0,
+            sumOfEvenSquares
+        );
+
+        std::cout << "sum = " << sum << std::endl;  // 220
+
+        // the eager variants accept input iterators, too
+        std::istringstream words{ "one two three four" };
+        std::vector<std::string> shortWords = filter(
+            std::istream_iterator<std::string>{ words },
+            std::istream_iterator<std::string>{},
+            [](const std::string& word) { return word.size() == 3; }
+        );
+
+        std::cout << shortWords.size() << " short words" << std::endl;  // 2
+
+        // records of a file
+        std::filesystem::path path{ std::filesystem::temp_directory_path() / "FunctionalProgramming_06a.txt" };
+        {
+            std::ofstream file{ path };
+            file << "C;Dennis Ritchie;1972;11.99\n"
+                 << "Java;James Gosling;1995;19.99\n"
+                 << "C++;Bjarne Stroustrup;1985;20.00\r\n"
+                 << "C#;Anders Hejlsberg;2000;29.99";  // no '\n' at the end
+        }
+
+        {
+            LineReader reader{ path, 16 };  // small buffer: lines cross block boundaries
+
+            std::string titles = fold(
+                std::begin(reader),
+                std::end(reader),
+                std::string{},
+                pipe(
+                    mapping(parseBookRecord),
+                    filtering([](const BookRecord& book) { return book.m_year >= 1990; }),
+                    mapping([](const BookRecord& book) { return book.m_title; })
+                )(
+                    [](std::string result, std::string_view title) {
+                        if (!result.empty()) {
+                            result += ", ";
+                        }
+                        result += title;
+                        return result;
+                    }
+                )
+            );
+
+            std::cout << titles << " (" << reader.bytesRead() << " bytes)" << std::endl;  // Java, C#
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    constexpr size_t StreamingRecords{ 4000000 };
+
+    void test_functional_streaming_06_benchmark()
+    {
+        std::filesystem::path path{ std::filesystem::temp_directory_path() / "FunctionalProgramming_06.txt" };
+        {
+            std::ofstream file{ path, std::ios::binary };
+            for (size_t i{}; i != StreamingRecords; ++i) {
+                file << "Title " << i << ";Author " << (i % 100) << ';' << (1950 + i % 70) << ';' << 0.5 * (i % 100) << '\n';
+            }
+        }
+
+        double bytes{ static_cast<double>(std::filesystem::file_size(path)) };
+        std::cout << "Streaming fold over a file (" << StreamingRecords << " records, " 
+            << bytes / 1e6 << " MB):" << std::endl;
+
+        Benchmarking::Options options{};
+        options.minRuns = 3;
+
+        auto report = [&](const std::string& label, const Benchmarking::Statistics& statistics) {
+            Benchmarking::print(std::cout, label, statistics);
+            std::cout << "    => " << static_cast<size_t>(bytes / statistics.median / 1e6) << " MB/s" << std::endl;
+        };
+
+        auto pricesOfRecentBooks = pipe(
+            mapping(parseBookRecord),
+            filtering([](const BookRecord& book) { return book.m_year >= 1990; }),
+            mapping([](const BookRecord& book) { return book.m_price; })
+        )(std::plus<>{});
+
+        size_t lines{};
+        report("LineReader, lines only", Benchmarking::measure([&]() {
+            LineReader reader{ path };
+            lines = fold(std::begin(reader), std::end(reader), size_t{}, 
+                [](size_t count, std::string_view) { return count + 1; }
+            );
+        }, options));
+
+        double streamingSum{};
+        report("LineReader, parse/filter/map", Benchmarking::measure([&]() {
+            LineReader reader{ path };
+            streamingSum = fold(std::begin(reader), std::end(reader), 0.0, pricesOfRecentBooks);
+        }, options));
+
+        double getlineSum{};
+        report("std::getline, parse/filter/map", Benchmarking::measure([&]() {
+            std::ifstream file{ path, std::ios::binary };
+            std::string line;
+            getlineSum = 0.0;
+            while (std::getline(file, line)) {
+                getlineSum = pricesOfRecentBooks(getlineSum, std::string_view{ line });
+            }
+        }, options));
+
+        std::cout << "Lines: " << lines << ", results: " << streamingSum << " / " << getlineSum << std::endl;
+
+        std::filesystem::remove(path);
+    }
 }
 
 void main_functional_programming()
@@ -507,6 +1335,14 @@ void main_functional_programming()
     test_functional_fmr_pattern_04b();
     test_functional_fmr_pattern_04c();
     test_functional_fmr_pattern_04d();
+
+    // testing parallel 'map', 'filter' and 'fold'
+    test_functional_parallel_05a();
+    test_functional_parallel_05_benchmark();
+
+    // testing streaming folds
+    test_functional_streaming_06a();
+    test_functional_streaming_06_benchmark();
 }
 
 // =====================================================================================
@@ -3,6 +3,7 @@
 // =====================================================================================
 
 #include <iostream>
+#include <iomanip>
 #include <string>
 #include <algorithm>
 #include <numeric>
@@ -10,74 +11,471 @@
 #include <type_traits>
 #include <vector>
 #include <list>
+#include <memory>
 #include <sstream>
+#include <array>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "../Global/Benchmark.h"
 
 namespace FunctionalProgramming_02 {
 
+    // =================================================================================
+    // containers are passed by forwarding reference:
+    // an lvalue container is only read, never copied,
+    // the elements of an rvalue container are moved or reused in place
+
+    // 'value_type' instead of 'decltype(*it)': the elements of std::vector<bool>
+    // are proxy objects, their value type is 'bool'
+    template <typename TContainer>
+    using ElementType = typename std::iterator_traits<
+        decltype(std::begin(std::declval<TContainer&>()))>::value_type;
+
+    // element of 'cont': an rvalue reference if the container itself is an rvalue,
+    // proxy objects (std::vector<bool>) are passed through
+    template <typename TContainer, typename T>
+    decltype(auto) forwardElement(T&& element)
+    {
+        if constexpr (std::is_lvalue_reference_v<TContainer>) {
+            return std::forward<T>(element);
+        }
+        else {
+            return std::move(element);
+        }
+    }
+
+    template <typename TContainer>
+    using ForwardedElement = decltype(forwardElement<TContainer>(*std::begin(std::declval<TContainer&>())));
+
+    template <typename T>
+    struct IsVector : std::false_type {};
+
+    template <typename T, typename TAllocator>
+    struct IsVector<std::vector<T, TAllocator>> : std::true_type {};
+
+    // a non-const std::vector passed as rvalue: its buffer can be reused for the result
+    template <typename TContainer>
+    constexpr bool IsReusableVector =
+        !std::is_reference_v<TContainer> && !std::is_const_v<TContainer> && IsVector<TContainer>::value;
+
     // =================================================================================
 
-    // note: container is passed by value so that modifying the local copy
-    // does not affect the original container
+    // note: the accumulator is moved from step to step (std::accumulate copies it
+    // up to C++17), so appending to a string accumulator runs in linear time
     template <typename TContainer, typename TResult, typename TFunctor>
-    TResult foldLeft(TContainer cont, TResult&& init, TFunctor&& lambda)
+    std::decay_t<TResult> foldLeft(TContainer&& cont, TResult&& init, TFunctor&& lambda)
     {
-        return std::accumulate(
-            std::begin(cont),
-            std::end(cont),
-            std::move(init),
-            std::forward<TFunctor>(lambda));
+        std::decay_t<TResult> result{ std::forward<TResult>(init) };
+        for (auto it = std::begin(cont); it != std::end(cont); ++it) {
+            result = lambda(std::move(result), forwardElement<TContainer>(*it));
+        }
+        return result;
     }
 
     template <typename TContainer, typename TResult, typename TFunctor>
-    TResult foldRight(TContainer cont, TResult&& init, TFunctor&& lambda)
+    std::decay_t<TResult> foldRight(TContainer&& cont, TResult&& init, TFunctor&& lambda)
     {
-        return std::accumulate(
-            std::rbegin(cont),
-            std::rend(cont),
-            std::move(init),
-            std::forward<TFunctor>(lambda));
+        std::decay_t<TResult> result{ std::forward<TResult>(init) };
+        for (auto it = std::rbegin(cont); it != std::rend(cont); ++it) {
+            result = lambda(std::move(result), forwardElement<TContainer>(*it));
+        }
+        return result;
     }
 
     // =================================================================================
+    // result type of 'filter' and 'map': an rvalue std::vector is reused and returned
+    // as it is, including its allocator. All other containers yield a new
+    // std::vector<T> with the default allocator, T being the (mapped) value type
+
+    // rvalue vector: the surviving elements are moved to the front, no new buffer is needed
+    template <typename TContainer, typename TFunctor, 
+        typename = std::enable_if_t<IsReusableVector<TContainer>>>
+    TContainer filter(TContainer&& cont, TFunctor&& lambda)
+    {
+        cont.erase(
+            std::remove_if(
+                std::begin(cont),
+                std::end(cont),
+                [&](const auto& element) { return !lambda(element); }
+            ),
+            std::end(cont)
+        );
+        return std::move(cont);
+    }
 
-    template <typename TContainer, typename TFunctor>
+    template <typename TContainer, typename TFunctor, 
+        typename = std::enable_if_t<!IsReusableVector<TContainer>>, typename = void>
     auto filter(TContainer&& cont, TFunctor&& lambda)
 
         // not needed, just for demonstration purposes
-        ->std::vector<typename std::remove_reference<decltype (cont[0])>::type >
+        -> std::vector<ElementType<TContainer>>
     {
-        using ValueType0 = decltype (cont[0]);  // retrieve type of single container element
-        using ValueType = typename std::remove_reference<ValueType0>::type;  
+        using ValueType = ElementType<TContainer>;  // retrieve type of single container element
 
+        // no 'reserve': the input size would be too much if only a few elements pass the filter,
+        // and counting the matches first would call the predicate twice per element
         std::vector<ValueType> result;
-        result.reserve(std::distance(std::begin(cont), std::end(cont)));
-        std::copy_if(
-            std::begin(cont),
-            std::end(cont), 
-            std::back_inserter(result),
-            std::forward<TFunctor>(lambda)
-        );
+        for (auto it = std::begin(cont); it != std::end(cont); ++it) {
+            auto&& element = *it;
+            if (lambda(std::as_const(element))) {
+                result.push_back(forwardElement<TContainer>(element));
+            }
+        }
         return result;
     }
 
     // =================================================================================
 
     template <typename TFunctor, typename TContainer>
-    auto map(TContainer cont, TFunctor&& lambda)
+    using MapResultType = std::decay_t<decltype(std::declval<TFunctor&>()(
+        std::declval<ForwardedElement<TContainer>>()))>;
+
+    template <typename TFunctor, typename TContainer>
+    constexpr bool IsInPlaceMap =
+        IsReusableVector<TContainer> && std::is_same_v<MapResultType<TFunctor, TContainer>, ElementType<TContainer>>;
+
+    // rvalue vector, same element type: every element is replaced in place
+    template <typename TFunctor, typename TContainer, 
+        typename = std::enable_if_t<IsInPlaceMap<TFunctor, TContainer>>>
+    TContainer map(TContainer&& cont, TFunctor&& lambda)
+    {
+        for (auto&& element : cont) {
+            element = lambda(std::move(element));
+        }
+        return std::move(cont);
+    }
+
+    template <typename TFunctor, typename TContainer,
+        typename = std::enable_if_t<!IsInPlaceMap<TFunctor, TContainer>>, typename = void>
+    auto map(TContainer&& cont, TFunctor&& lambda)
         // not needed, just for demonstration purposes
-       -> std::vector<decltype(std::declval<TFunctor>()(std::declval<typename TContainer::value_type>()))>
+       -> std::vector<MapResultType<TFunctor, TContainer>>
     {
-        std::vector<decltype(std::declval<TFunctor>()(std::declval<typename TContainer::value_type>()))> result;
+        std::vector<MapResultType<TFunctor, TContainer>> result;
+        result.reserve(std::distance(std::begin(cont), std::end(cont)));
 
-        std::transform(
-            std::begin(cont),
-            std::end(cont),
-            std::back_inserter(result),
-            std::forward<TFunctor>(lambda));
+        for (auto it = std::begin(cont); it != std::end(cont); ++it) {
+            result.push_back(lambda(forwardElement<TContainer>(*it)));
+        }
 
         return result;
     }
 
+    // =================================================================================
+    // linear-time string folding: 'join' and 'concat' compute the size of the
+    // result first, reserve it once and append all pieces in place
+
+    // a piece is a string-like value or a range of string-like values,
+    // e.g. std::array<std::string_view, 4>{ title, " [", author, "]" }
+    template <typename T>
+    constexpr bool IsStringLike = std::is_convertible_v<const T&, std::string_view>;
+
+    template <typename T>
+    size_t lengthOf(const T& piece)
+    {
+        if constexpr (IsStringLike<T>) {
+            return std::string_view{ piece }.size();
+        }
+        else {
+            size_t length{};
+            for (const auto& part : piece) {
+                length += lengthOf(part);
+            }
+            return length;
+        }
+    }
+
+    template <typename T>
+    void appendTo(std::string& result, const T& piece)
+    {
+        if constexpr (IsStringLike<T>) {
+            result.append(std::string_view{ piece });
+        }
+        else {
+            for (const auto& part : piece) {
+                appendTo(result, part);
+            }
+        }
+    }
+
+    struct Identity {
+        template <typename T>
+        const T& operator()(const T& value) const { return value; }
+    };
+
+    // 'projection' is called twice per element (size and contents),
+    // so it should return views instead of new strings
+    template <typename TContainer, typename TProjection = Identity>
+    std::string join(const TContainer& cont, std::string_view separator, TProjection projection = TProjection{})
+    {
+        size_t length{};
+        size_t count{};
+        for (const auto& element : cont) {
+            length += lengthOf(projection(element));
+            ++count;
+        }
+        if (count > 1) {
+            length += (count - 1) * separator.size();
+        }
+
+        std::string result;
+        result.reserve(length);
+
+        bool first{ true };
+        for (const auto& element : cont) {
+            if (!first) {
+                result.append(separator);
+            }
+            first = false;
+            appendTo(result, projection(element));
+        }
+        return result;
+    }
+
+    template <typename TContainer, typename TProjection = Identity>
+    std::string concat(const TContainer& cont, TProjection projection = TProjection{})
+    {
+        return join(cont, std::string_view{}, projection);
+    }
+
+    // =================================================================================
+    // lazy pipelines: 'range | filter(...) | map(...) | fold(...)'
+    // 
+    // the stages 'filter', 'map', 'take' and 'takeWhile' only describe what to do,
+    // the terminal stage 'fold' composes all stages into a single chain of calls
+    // and runs one loop over the source range - no intermediate containers
+
+    namespace Lazy {
+
+        template <typename TPredicate>
+        struct FilterStage {
+            TPredicate m_predicate;
+
+            template <typename TSink>
+            auto wrap(TSink sink) const {
+                return [predicate = m_predicate, sink](auto&& element) mutable -> bool {
+                    if (predicate(element)) {
+                        return sink(std::forward<decltype(element)>(element));
+                    }
+                    return true;
+                };
+            }
+        };
+
+        template <typename TFunctor>
+        struct MapStage {
+            TFunctor m_functor;
+
+            template <typename TSink>
+            auto wrap(TSink sink) const {
+                return [functor = m_functor, sink](auto&& element) mutable -> bool {
+                    return sink(functor(std::forward<decltype(element)>(element)));
+                };
+            }
+        };
+
+        // early termination: a sink returning 'false' stops the loop over the source
+        struct TakeStage {
+            size_t m_count;
+
+            template <typename TSink>
+            auto wrap(TSink sink) const {
+                return [remaining = m_count, sink](auto&& element) mutable -> bool {
+                    if (remaining == 0) {
+                        return false;
+                    }
+                    --remaining;
+                    return sink(std::forward<decltype(element)>(element)) && remaining != 0;
+                };
+            }
+        };
+
+        template <typename TPredicate>
+        struct TakeWhileStage {
+            TPredicate m_predicate;
+
+            template <typename TSink>
+            auto wrap(TSink sink) const {
+                return [predicate = m_predicate, sink](auto&& element) mutable -> bool {
+                    if (!predicate(element)) {
+                        return false;
+                    }
+                    return sink(std::forward<decltype(element)>(element));
+                };
+            }
+        };
+
+        template <typename TResult, typename TFunctor>
+        struct FoldStage {
+            TResult m_init;
+            TFunctor m_functor;
+        };
+
+        // string builder: the result grows in place - the size is not known in advance,
+        // an expected size may be passed to reserve the memory at once
+        struct JoinStage {
+            std::string m_separator;
+            size_t m_capacity;
+        };
+
+        // building the stages
+        template <typename TPredicate>
+        FilterStage<std::decay_t<TPredicate>> filter(TPredicate&& predicate) {
+            return { std::forward<TPredicate>(predicate) };
+        }
+
+        template <typename TFunctor>
+        MapStage<std::decay_t<TFunctor>> map(TFunctor&& functor) {
+            return { std::forward<TFunctor>(functor) };
+        }
+
+        inline TakeStage take(size_t count) {
+            return { count };
+        }
+
+        template <typename TPredicate>
+        TakeWhileStage<std::decay_t<TPredicate>> takeWhile(TPredicate&& predicate) {
+            return { std::forward<TPredicate>(predicate) };
+        }
+
+        template <typename TResult, typename TFunctor>
+        FoldStage<std::decay_t<TResult>, std::decay_t<TFunctor>> fold(TResult&& init, TFunctor&& functor) {
+            return { std::forward<TResult>(init), std::forward<TFunctor>(functor) };
+        }
+
+        inline JoinStage join(std::string_view separator, size_t capacity = 0) {
+            return { std::string{ separator }, capacity };
+        }
+
+        inline JoinStage concat(size_t capacity = 0) {
+            return { std::string{}, capacity };
+        }
+
+        // =============================================================================
+
+        // source range and stages, 'TRange' is a reference type for lvalue ranges,
+        // rvalue ranges are moved into the pipeline
+        template <typename TRange, typename... TStages>
+        class Pipeline {
+        private:
+            TRange m_range;
+            std::tuple<TStages...> m_stages;
+
+        public:
+            Pipeline(TRange&& range, std::tuple<TStages...>&& stages)
+                : m_range{ std::forward<TRange>(range) }, m_stages{ std::move(stages) } {}
+
+            template <typename TStage>
+            Pipeline<TRange, TStages..., TStage> append(TStage&& stage) && {
+                return { 
+                    std::forward<TRange>(m_range), 
+                    std::tuple_cat(std::move(m_stages), std::make_tuple(std::forward<TStage>(stage)))
+                };
+            }
+
+            // pushes every element of the range through the stages into 'sink'
+            template <typename TSink>
+            void run(TSink sink) {
+                auto chain{ compose<0>(sink) };
+                for (auto&& element : m_range) {
+                    if (!chain(element)) {
+                        break;
+                    }
+                }
+            }
+
+        private:
+            template <size_t Index, typename TSink>
+            auto compose(TSink sink) const {
+                if constexpr (Index == sizeof...(TStages)) {
+                    return sink;
+                }
+                else {
+                    return std::get<Index>(m_stages).wrap(compose<Index + 1>(sink));
+                }
+            }
+        };
+
+        template <typename T>
+        struct IsStage : std::false_type {};
+
+        template <typename TPredicate>
+        struct IsStage<FilterStage<TPredicate>> : std::true_type {};
+
+        template <typename TFunctor>
+        struct IsStage<MapStage<TFunctor>> : std::true_type {};
+
+        template <>
+        struct IsStage<TakeStage> : std::true_type {};
+
+        template <typename TPredicate>
+        struct IsStage<TakeWhileStage<TPredicate>> : std::true_type {};
+
+        template <typename T>
+        struct IsPipeline : std::false_type {};
+
+        template <typename TRange, typename... TStages>
+        struct IsPipeline<Pipeline<TRange, TStages...>> : std::true_type {};
+
+        // range | stage
+        template <typename TRange, typename TStage, typename = std::enable_if_t<
+            IsStage<std::decay_t<TStage>>::value && !IsPipeline<std::decay_t<TRange>>::value>>
+        Pipeline<TRange, std::decay_t<TStage>> operator| (TRange&& range, TStage&& stage) {
+            return { std::forward<TRange>(range), std::make_tuple(std::forward<TStage>(stage)) };
+        }
+
+        // pipeline | stage
+        template <typename TRange, typename... TStages, typename TStage, 
+            typename = std::enable_if_t<IsStage<std::decay_t<TStage>>::value>>
+        auto operator| (Pipeline<TRange, TStages...>&& pipeline, TStage&& stage) {
+            return std::move(pipeline).append(std::forward<TStage>(stage));
+        }
+
+        // pipeline | fold: runs the pipeline
+        template <typename TRange, typename... TStages, typename TResult, typename TFunctor>
+        TResult operator| (Pipeline<TRange, TStages...>&& pipeline, FoldStage<TResult, TFunctor>&& fold) {
+            TResult result{ std::move(fold.m_init) };
+            pipeline.run([&](auto&& element) {
+                result = fold.m_functor(std::move(result), std::forward<decltype(element)>(element));
+                return true;
+            });
+            return result;
+        }
+
+        // range | fold
+        template <typename TRange, typename TResult, typename TFunctor, 
+            typename = std::enable_if_t<!IsPipeline<std::decay_t<TRange>>::value>>
+        TResult operator| (TRange&& range, FoldStage<TResult, TFunctor>&& fold) {
+            return Pipeline<TRange>{ std::forward<TRange>(range), std::tuple<>{} } | std::move(fold);
+        }
+
+        // pipeline | join: runs the pipeline
+        template <typename TRange, typename... TStages>
+        std::string operator| (Pipeline<TRange, TStages...>&& pipeline, JoinStage&& join) {
+            std::string result;
+            result.reserve(join.m_capacity);
+
+            bool first{ true };
+            pipeline.run([&](auto&& element) {
+                if (!first) {
+                    result.append(join.m_separator);
+                }
+                first = false;
+                appendTo(result, element);
+                return true;
+            });
+            return result;
+        }
+
+        // range | join
+        template <typename TRange, typename = std::enable_if_t<!IsPipeline<std::decay_t<TRange>>::value>>
+        std::string operator| (TRange&& range, JoinStage&& join) {
+            return Pipeline<TRange>{ std::forward<TRange>(range), std::tuple<>{} } | std::move(join);
+        }
+    }
+
     // =================================================================================
     // testing 'filter'
 
@@ -365,20 +763,8 @@ namespace FunctionalProgramming_02 {
             [](const Book& book) { return book.m_title; }  // convert Book to string
         );
 
-        std::string result3 = foldLeft(
-            result2,
-            std::string(""),
-            [](std::string a, std::string b) {
-                std::ostringstream oss;
-                if (a.empty()) {
-                    oss << b;
-                }
-                else {
-                    oss << a << ", " << b;
-                }
-                return oss.str();
-            }
-        );
+        // linear time: the size of the result is computed first, one allocation
+        std::string result3 = join(result2, ", ");
 
         std::cout << result3 << std::endl;
     }
@@ -450,18 +836,12 @@ namespace FunctionalProgramming_02 {
             [](const Book& book) { return SearchResult{ book.m_title, book.m_author }; }
         );
 
-        std::string result3 = foldLeft(
+        // linear time: each element contributes several pieces
+        std::string result3 = join(
             result2,
-            std::string(""),
-            [](std::string a, SearchResult b) -> std::string {
-                std::ostringstream oss;
-                if (a.empty()) {
-                    oss << b.m_title << " [" << b.m_author << ']';
-                }
-                else {
-                    oss << a << " | " << b.m_title << " [" << b.m_author << ']';
-                }
-                return oss.str();
+            " | ",
+            [](const SearchResult& b) {
+                return std::array<std::string_view, 4>{ b.m_title, " [", b.m_author, "]" };
             }
         );
 
@@ -583,6 +963,393 @@ namespace FunctionalProgramming_02 {
 
         std::cout << result << std::endl;
     }
+    // =================================================================================
+    // testing lazy pipelines
+
+    void test_functional_pipeline_05a() {
+
+        using namespace Lazy;
+
+        std::vector<Book> booksList{
+            {"C", "Dennis Ritchie", 1972, 11.99 } ,
+            {"Java", "James Gosling", 1995, 19.99 },
+            {"C++", "Bjarne Stroustrup", 1985, 20.00 },
+            {"C#", "Anders Hejlsberg", 2000, 29.99 }
+        };
+
+        // a) filter books which appeared past 1990
+        // b) extract book title
+        // c) reduce to result string, e.g. comma separated list
+        // single loop over 'booksList', no intermediate vectors
+
+        std::string result = booksList
+            | filter([](const Book& book) { return book.m_year >= 1990; })
+            | map([](const Book& book) { return book.m_title; })
+            | fold(std::string(""), [](std::string a, const std::string& b) {
+                    if (!a.empty()) {
+                        a += ", ";
+                    }
+                    a += b;
+                    return a;
+                });
+
+        std::cout << result << std::endl;
+
+        double sum = booksList
+            | map([](const Book& book) { return book.m_price; })
+            | fold(0.0, std::plus<>{});
+
+        std::cout << sum << std::endl;
+    }
+
+    void test_functional_pipeline_05b() {
+
+        using namespace Lazy;
+
+        std::vector<int> numbers(1000000);
+        std::iota(std::begin(numbers), std::end(numbers), 1);
+
+        // early termination: only the first 5 even numbers are visited
+        size_t visited{};
+        int sum = numbers
+            | filter([&](int n) { ++visited; return n % 2 == 0; })
+            | take(5)
+            | fold(0, std::plus<>{});
+
+        std::cout << "sum = " << sum << ", visited elements: " << visited << std::endl;  // 30, 10
+
+        // stop as soon as the predicate fails
+        int sumOfSmall = numbers
+            | takeWhile([](int n) { return n <= 100; })
+            | fold(0, std::plus<>{});
+
+        std::cout << "sumOfSmall = " << sumOfSmall << std::endl;  // 5050
+    }
+
+    constexpr size_t BenchmarkBooks{ 10000000 };
+
+    void test_functional_pipeline_05_benchmark() {
+
+        std::cout << "Lazy pipeline vs. eager filter/map/fold (" << BenchmarkBooks << " books):" << std::endl;
+
+        std::vector<Book> booksList;
+        booksList.reserve(BenchmarkBooks);
+        for (size_t i{}; i != BenchmarkBooks; ++i) {
+            booksList.push_back({ "Title " + std::to_string(i % 1000), "Author", 1950 + static_cast<int>(i % 70), 0.5 * (i % 100) });
+        }
+
+        Benchmarking::Options options{};
+        options.minRuns = 3;
+
+        double eagerSum{};
+        Benchmarking::Statistics eager{ Benchmarking::measure([&]() {
+            eagerSum = foldLeft(
+                map(
+                    filter(
+                        booksList,
+                        [](const Book& book) { return book.m_year >= 1990; }
+                    ),
+                    [](const Book& book) { return book.m_price; }
+                ),
+                0.0,
+                std::plus<>{}
+            );
+        }, options) };
+        Benchmarking::print(std::cout, "Eager (filter, map, foldLeft)", eager);
+
+        double lazySum{};
+        Benchmarking::Statistics lazy{ Benchmarking::measure([&]() {
+            using namespace Lazy;
+            lazySum = booksList
+                | filter([](const Book& book) { return book.m_year >= 1990; })
+                | map([](const Book& book) { return book.m_price; })
+                | fold(0.0, std::plus<>{});
+        }, options) };
+        Benchmarking::print(std::cout, "Lazy pipeline", lazy);
+
+        std::cout << "Results: " << eagerSum << " / " << lazySum << std::endl;
+
+        double firstPrices{};
+        Benchmarking::Statistics early{ Benchmarking::measure([&]() {
+            using namespace Lazy;
+            firstPrices = booksList
+                | filter([](const Book& book) { return book.m_year >= 1990; })
+                | map([](const Book& book) { return book.m_price; })
+                | take(10)
+                | fold(0.0, std::plus<>{});
+        }, options) };
+        Benchmarking::print(std::cout, "Lazy pipeline, take(10)", early);
+
+        std::cout << "Sum of first 10 prices: " << firstPrices << std::endl;
+    }
+    // =================================================================================
+    // testing linear-time string folding
+
+    void test_functional_join_06a() {
+
+        std::vector<Book> booksList{
+            {"C", "Dennis Ritchie", 1972, 11.99 } ,
+            {"Java", "James Gosling", 1995, 19.99 },
+            {"C++", "Bjarne Stroustrup", 1985, 20.00 },
+            {"C#", "Anders Hejlsberg", 2000, 29.99 }
+        };
+
+        std::cout << join(booksList, ", ", [](const Book& book) { return std::string_view{ book.m_title }; }) << std::endl;
+
+        std::cout << concat(booksList, [](const Book& book) { 
+            return std::array<std::string_view, 2>{ book.m_title, ";" };
+        }) << std::endl;
+
+        // terminal stage of a lazy pipeline
+        using namespace Lazy;
+
+        std::string result = booksList
+            | filter([](const Book& book) { return book.m_year >= 1990; })
+            | map([](const Book& book) { 
+                return std::array<std::string_view, 4>{ book.m_title, " [", book.m_author, "]" };
+            })
+            | join(" | ");
+
+        std::cout << result << std::endl;
+    }
+
+    constexpr size_t BenchmarkTitles{ 1000000 };
+    constexpr size_t QuadraticTitles{ 20000 };  // 'ostringstream' fold, quadratic
+
+    void test_functional_join_06_benchmark() {
+
+        std::cout << "Folding titles into a single string:" << std::endl;
+
+        std::vector<std::string> titles;
+        titles.reserve(BenchmarkTitles);
+        for (size_t i{}; i != BenchmarkTitles; ++i) {
+            titles.push_back("Title " + std::to_string(i));
+        }
+
+        Benchmarking::Options options{};
+        options.minRuns = 3;
+
+        // previous approach: the accumulated string is copied in every step
+        std::vector<std::string> fewTitles(std::begin(titles), std::begin(titles) + QuadraticTitles);
+        Benchmarking::print(std::cout, "ostringstream fold, " + std::to_string(QuadraticTitles), 
+            Benchmarking::measure([&]() {
+                std::string result = foldLeft(
+                    fewTitles,
+                    std::string(""),
+                    [](std::string a, std::string b) {
+                        std::ostringstream oss;
+                        if (a.empty()) {
+                            oss << b;
+                        }
+                        else {
+                            oss << a << ", " << b;
+                        }
+                        return oss.str();
+                    }
+                );
+                Benchmarking::doNotOptimize(result);
+            }, options));
+
+        std::string suffix{ ", " + std::to_string(BenchmarkTitles) };
+
+        Benchmarking::print(std::cout, "Appending fold" + suffix, Benchmarking::measure([&]() {
+            std::string result = foldLeft(
+                titles,
+                std::string(""),
+                [](std::string a, const std::string& b) {
+                    if (!a.empty()) {
+                        a += ", ";
+                    }
+                    a += b;
+                    return a;
+                }
+            );
+            Benchmarking::doNotOptimize(result);
+        }, options));
+
+        Benchmarking::print(std::cout, "join" + suffix, Benchmarking::measure([&]() {
+            std::string result = join(titles, ", ");
+            Benchmarking::doNotOptimize(result);
+        }, options));
+
+        Benchmarking::print(std::cout, "Pipeline join" + suffix, Benchmarking::measure([&]() {
+            using namespace Lazy;
+            std::string result = titles | join(", ");
+            Benchmarking::doNotOptimize(result);
+        }, options));
+    }
+    // =================================================================================
+    // testing move-aware signatures: counting copies and allocations
+
+    class Probe {
+    public:
+        static inline size_t s_copies{};
+        static inline size_t s_moves{};
+
+        int m_value;
+
+        Probe(int value) : m_value{ value } {}
+        Probe(const Probe& other) : m_value{ other.m_value } { ++s_copies; }
+        Probe(Probe&& other) noexcept : m_value{ other.m_value } { ++s_moves; }
+
+        Probe& operator= (const Probe& other) { m_value = other.m_value; ++s_copies; return *this; }
+        Probe& operator= (Probe&& other) noexcept { m_value = other.m_value; ++s_moves; return *this; }
+
+        static void reset() { s_copies = 0; s_moves = 0; }
+    };
+
+    // counts the buffers allocated for the source container
+    template <typename T>
+    class CountingAllocator {
+    public:
+        using value_type = T;
+
+        static inline size_t s_allocations{};
+
+        CountingAllocator() = default;
+
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U>&) {}
+
+        T* allocate(size_t n) {
+            ++s_allocations;
+            return std::allocator<T>{}.allocate(n);
+        }
+
+        void deallocate(T* ptr, size_t n) {
+            std::allocator<T>{}.deallocate(ptr, n);
+        }
+
+        friend bool operator== (const CountingAllocator&, const CountingAllocator&) { return true; }
+        friend bool operator!= (const CountingAllocator&, const CountingAllocator&) { return false; }
+    };
+
+    using ProbeVector = std::vector<Probe, CountingAllocator<Probe>>;
+
+    static ProbeVector makeProbes(int count) {
+        ProbeVector probes;
+        probes.reserve(count);
+        for (int i{ 1 }; i <= count; ++i) {
+            probes.emplace_back(i);
+        }
+        return probes;
+    }
+
+    static bool reportProbes(const std::string& label, size_t expectedCopies) {
+        bool ok{ Probe::s_copies == expectedCopies };
+        std::cout << (ok ? "ok     " : "FAILED ") 
+            << std::left << std::setw(40) << label << std::right
+            << "copies: " << Probe::s_copies 
+            << ", moves: " << Probe::s_moves
+            << ", buffers: " << CountingAllocator<Probe>::s_allocations;
+        if (!ok) {
+            std::cout << "  <== expected " << expectedCopies << " copies";
+        }
+        std::cout << std::endl;
+        return ok;
+    }
+
+    void test_functional_move_aware_07() {
+
+        constexpr int Count{ 100 };
+
+        auto isEven = [](const Probe& probe) { return probe.m_value % 2 == 0; };
+
+        bool passed{ true };
+
+        // lvalue source: nothing is copied
+        {
+            ProbeVector source{ makeProbes(Count) };
+            Probe::reset();
+            CountingAllocator<Probe>::s_allocations = 0;
+
+            int sum = foldLeft(source, 0, [](int sum, const Probe& probe) { return sum + probe.m_value; });
+            passed = reportProbes("foldLeft (lvalue)", 0) && passed;
+
+            std::vector<int> doubled = map(source, [](const Probe& probe) { return 2 * probe.m_value; });
+            passed = reportProbes("map, other type (lvalue)", 0) && passed;
+
+            std::cout << "sum = " << sum << ", doubled.size() = " << doubled.size() << std::endl;  // 5050, 100
+        }
+
+        // lvalue source: only the selected elements are copied into the result
+        {
+            ProbeVector source{ makeProbes(Count) };
+            Probe::reset();
+            CountingAllocator<Probe>::s_allocations = 0;
+
+            std::vector<Probe> even = filter(source, isEven);
+            passed = reportProbes("filter (lvalue), result elements only", even.size()) && passed;
+        }
+
+        // stateful predicate with a mutable call operator: called exactly once per element
+        {
+            ProbeVector source{ makeProbes(Count) };
+            Probe::reset();
+            CountingAllocator<Probe>::s_allocations = 0;
+
+            size_t calls{};
+            std::vector<Probe> everyThird = filter(source, [&calls, n = 0](const Probe&) mutable {
+                ++calls;
+                return ++n % 3 == 0;
+            });
+            passed = reportProbes("filter (lvalue), mutable predicate", everyThird.size()) && passed;
+
+            bool once{ calls == Count && everyThird.size() == Count / 3 };
+            std::cout << (once ? "ok     " : "FAILED ") << "predicate calls: " << calls << std::endl;  // 100
+            passed = once && passed;
+        }
+
+        // rvalue source: filter and map reuse the buffer, fold moves the elements
+        {
+            ProbeVector source{ makeProbes(Count) };
+            Probe::reset();
+            CountingAllocator<Probe>::s_allocations = 0;
+
+            int sum = foldLeft(
+                map(
+                    filter(std::move(source), isEven),
+                    [](Probe&& probe) { probe.m_value *= 2; return std::move(probe); }
+                ),
+                0,
+                [](int sum, Probe&& probe) { return sum + probe.m_value; }
+            );
+            passed = reportProbes("foldLeft(map(filter(...))) (rvalue)", 0) && passed;
+
+            std::cout << "sum = " << sum << std::endl;  // 5100
+        }
+
+        // rvalue source, other element type: elements are moved into the functor
+        {
+            ProbeVector source{ makeProbes(Count) };
+            Probe::reset();
+            CountingAllocator<Probe>::s_allocations = 0;
+
+            std::vector<std::string> texts = map(
+                std::move(source),
+                [](Probe probe) { return std::to_string(probe.m_value); }
+            );
+            passed = reportProbes("map, other type (rvalue)", 0) && passed;
+
+            std::cout << join(texts, ", ").substr(0, 20) << " ..." << std::endl;
+        }
+
+        // std::vector<bool>: the elements are proxy objects, not references
+        {
+            std::vector<bool> flags{ true, false, true, true, false };
+
+            std::vector<bool> set = filter(flags, [](bool flag) { return flag; });
+            std::vector<bool> inverted = map(std::vector<bool>{ flags }, [](bool flag) { return !flag; });
+            std::vector<int> numbers = map(flags, [](bool flag) { return flag ? 1 : 0; });
+
+            bool ok{ set.size() == 3 && inverted == std::vector<bool>{ false, true, false, false, true } &&
+                std::accumulate(numbers.begin(), numbers.end(), 0) == 3 };
+            std::cout << (ok ? "ok     " : "FAILED ") << "filter and map of std::vector<bool>" << std::endl;
+            passed = ok && passed;
+        }
+
+        std::cout << "Move-aware functions: " << (passed ? "ok" : "FAILED") << std::endl;
+    }
 }
 
 void main_functional_programming_alternate()
@@ -613,6 +1380,18 @@ void main_functional_programming_alternate()
     test_functional_fmr_pattern_04c_compact();
     test_functional_fmr_pattern_04d();
     test_functional_fmr_pattern_04d_compact();
+
+    // testing lazy pipelines
+    test_functional_pipeline_05a();
+    test_functional_pipeline_05b();
+    test_functional_pipeline_05_benchmark();
+
+    // testing linear-time string folding
+    test_functional_join_06a();
+    test_functional_join_06_benchmark();
+
+    // testing move-aware signatures
+    test_functional_move_aware_07();
 }
 
 // =====================================================================================
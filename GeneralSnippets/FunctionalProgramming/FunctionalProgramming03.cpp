@@ -0,0 +1,689 @@
+// =====================================================================================
+// Functional Programming - Variante 3: Spaltenorientierte Tabellen
+// =====================================================================================
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "../Global/Benchmark.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FUNCTIONAL_PROGRAMMING_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace FunctionalProgramming_03 {
+
+    // =================================================================================
+    // array of structures: a filter on 'm_year' drags both strings through the cache
+
+    class Book {
+    public:
+        std::string m_title;
+        std::string m_author;
+        int m_year;
+        double m_price;
+    };
+
+    class SearchResult {
+    public:
+        std::string m_title;
+        std::string m_author;
+    };
+
+    // =================================================================================
+    // bit manipulation
+
+    inline size_t popCount(uint64_t word)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return static_cast<size_t>(__popcnt64(word));
+#elif defined(_MSC_VER)
+        size_t count{};
+        for (; word != 0; word &= word - 1) {
+            ++count;
+        }
+        return count;
+#else
+        return static_cast<size_t>(__builtin_popcountll(word));
+#endif
+    }
+
+    // 'word' must not be 0
+    inline size_t countTrailingZeros(uint64_t word)
+    {
+#if defined(_MSC_VER) && defined(_M_X64)
+        unsigned long index{};
+        _BitScanForward64(&index, word);
+        return static_cast<size_t>(index);
+#elif defined(_MSC_VER)
+        size_t index{};
+        for (; (word & 1) == 0; word >>= 1) {
+            ++index;
+        }
+        return index;
+#else
+        return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+    }
+
+    // =================================================================================
+    // selection bitmap: bit 'i' is set if row 'i' satisfies the predicate
+
+    class Selection
+    {
+    private:
+        std::vector<uint64_t> m_words;
+        size_t m_rows;
+
+    public:
+        static constexpr size_t BitsPerWord{ 64 };
+
+        // c'tor
+        explicit Selection(size_t rows);
+
+        // getter
+        size_t rows() const { return m_rows; }
+        size_t words() const { return m_words.size(); }
+        uint64_t* data() { return m_words.data(); }
+        const uint64_t* data() const { return m_words.data(); }
+
+        bool test(size_t row) const;
+        size_t count() const;
+
+        // combining predicates
+        Selection& operator&= (const Selection&);
+        Selection& operator|= (const Selection&);
+        Selection operator~ () const;
+
+        // visits the indices of all selected rows in ascending order
+        template <typename TFunctor>
+        void forEach(TFunctor&& functor) const;
+
+    private:
+        void clearPadding();
+    };
+
+    Selection::Selection(size_t rows)
+        : m_words((rows + BitsPerWord - 1) / BitsPerWord), m_rows{ rows } {}
+
+    bool Selection::test(size_t row) const
+    {
+        return (m_words[row / BitsPerWord] >> (row % BitsPerWord)) & 1;
+    }
+
+    size_t Selection::count() const
+    {
+        size_t count{};
+        for (uint64_t word : m_words) {
+            count += popCount(word);
+        }
+        return count;
+    }
+
+    Selection& Selection::operator&= (const Selection& other)
+    {
+        for (size_t i{}; i != m_words.size(); ++i) {
+            m_words[i] &= other.m_words[i];
+        }
+        return *this;
+    }
+
+    Selection& Selection::operator|= (const Selection& other)
+    {
+        for (size_t i{}; i != m_words.size(); ++i) {
+            m_words[i] |= other.m_words[i];
+        }
+        return *this;
+    }
+
+    Selection Selection::operator~ () const
+    {
+        Selection result{ m_rows };
+        for (size_t i{}; i != m_words.size(); ++i) {
+            result.m_words[i] = ~m_words[i];
+        }
+        result.clearPadding();
+        return result;
+    }
+
+    // bits behind the last row must stay 0, otherwise 'count' and 'forEach' see them
+    void Selection::clearPadding()
+    {
+        size_t used{ m_rows % BitsPerWord };
+        if (used != 0) {
+            m_words.back() &= (uint64_t{ 1 } << used) - 1;
+        }
+    }
+
+    template <typename TFunctor>
+    void Selection::forEach(TFunctor&& functor) const
+    {
+        for (size_t i{}; i != m_words.size(); ++i) {
+            for (uint64_t word{ m_words[i] }; word != 0; word &= word - 1) {
+                functor(i * BitsPerWord + countTrailingZeros(word));
+            }
+        }
+    }
+
+    inline Selection operator& (Selection lhs, const Selection& rhs) { return lhs &= rhs; }
+    inline Selection operator| (Selection lhs, const Selection& rhs) { return lhs |= rhs; }
+
+    // =================================================================================
+    // predicate kernels: 64 rows at a time, one word of the bitmap per block
+
+    enum class Compare { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual };
+
+    template <Compare Op, typename T>
+    inline bool compare(const T& lhs, const T& rhs)
+    {
+        if constexpr (Op == Compare::Less)              return lhs < rhs;
+        else if constexpr (Op == Compare::LessEqual)    return lhs <= rhs;
+        else if constexpr (Op == Compare::Greater)      return lhs > rhs;
+        else if constexpr (Op == Compare::GreaterEqual) return lhs >= rhs;
+        else if constexpr (Op == Compare::Equal)        return lhs == rhs;
+        else                                            return lhs != rhs;
+    }
+
+    // branch-free, but compilers hardly vectorize it
+    template <Compare Op, typename T>
+    inline uint64_t compareScalar(const T* values, size_t count, const T& value)
+    {
+        uint64_t bits{};
+        for (size_t j{}; j != count; ++j) {
+            bits |= static_cast<uint64_t>(compare<Op>(values[j], value)) << j;
+        }
+        return bits;
+    }
+
+#if defined(FUNCTIONAL_PROGRAMMING_SSE2)
+
+    // SSE2 is part of every x64 processor: 4 ints or 2 doubles per instruction
+    template <Compare Op>
+    inline uint64_t compareBlock(const int32_t* values, int32_t value)
+    {
+        const __m128i broadcast{ _mm_set1_epi32(value) };
+
+        uint64_t bits{};
+        for (size_t j{}; j != Selection::BitsPerWord; j += 4) {
+            __m128i packet{ _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + j)) };
+
+            // SSE2 has only <, > and ==, the other results are inverted
+            __m128i mask{};
+            if constexpr (Op == Compare::Less || Op == Compare::GreaterEqual) {
+                mask = _mm_cmplt_epi32(packet, broadcast);
+            }
+            else if constexpr (Op == Compare::Greater || Op == Compare::LessEqual) {
+                mask = _mm_cmpgt_epi32(packet, broadcast);
+            }
+            else {
+                mask = _mm_cmpeq_epi32(packet, broadcast);
+            }
+
+            uint64_t nibble{ static_cast<uint64_t>(_mm_movemask_ps(_mm_castsi128_ps(mask))) };
+            if constexpr (Op == Compare::GreaterEqual || Op == Compare::LessEqual || Op == Compare::NotEqual) {
+                nibble ^= 0xF;
+            }
+            bits |= nibble << j;
+        }
+        return bits;
+    }
+
+    // interned string ids: only (in)equality is vectorized, ordering ids is meaningless anyway
+    template <Compare Op>
+    inline uint64_t compareBlock(const uint32_t* values, uint32_t value)
+    {
+        if constexpr (Op == Compare::Equal || Op == Compare::NotEqual) {
+            return compareBlock<Op>(reinterpret_cast<const int32_t*>(values), static_cast<int32_t>(value));
+        }
+        else {
+            return compareScalar<Op>(values, Selection::BitsPerWord, value);
+        }
+    }
+
+    template <Compare Op>
+    inline uint64_t compareBlock(const double* values, double value)
+    {
+        const __m128d broadcast{ _mm_set1_pd(value) };
+
+        uint64_t bits{};
+        for (size_t j{}; j != Selection::BitsPerWord; j += 2) {
+            __m128d packet{ _mm_loadu_pd(values + j) };
+
+            __m128d mask{};
+            if constexpr (Op == Compare::Less)              mask = _mm_cmplt_pd(packet, broadcast);
+            else if constexpr (Op == Compare::LessEqual)    mask = _mm_cmple_pd(packet, broadcast);
+            else if constexpr (Op == Compare::Greater)      mask = _mm_cmpgt_pd(packet, broadcast);
+            else if constexpr (Op == Compare::GreaterEqual) mask = _mm_cmpge_pd(packet, broadcast);
+            else if constexpr (Op == Compare::Equal)        mask = _mm_cmpeq_pd(packet, broadcast);
+            else                                            mask = _mm_cmpneq_pd(packet, broadcast);
+
+            bits |= static_cast<uint64_t>(_mm_movemask_pd(mask)) << j;
+        }
+        return bits;
+    }
+
+#endif
+
+    template <Compare Op, typename T>
+    inline uint64_t compareBlock(const T* values, const T& value)
+    {
+        return compareScalar<Op>(values, Selection::BitsPerWord, value);
+    }
+
+    template <Compare Op, typename T>
+    void select(const T* values, size_t rows, const T& value, Selection& selection)
+    {
+        uint64_t* words{ selection.data() };
+
+        size_t blocks{ rows / Selection::BitsPerWord };
+        for (size_t i{}; i != blocks; ++i) {
+            words[i] = compareBlock<Op>(values + i * Selection::BitsPerWord, value);
+        }
+
+        // remaining rows
+        size_t rest{ rows % Selection::BitsPerWord };
+        if (rest != 0) {
+            words[blocks] = compareScalar<Op>(values + blocks * Selection::BitsPerWord, rest, value);
+        }
+    }
+
+    // =================================================================================
+    // typed column
+
+    template <typename T>
+    class Column
+    {
+    private:
+        std::vector<T> m_values;
+
+    public:
+        // c'tor
+        Column() = default;
+
+        void reserve(size_t rows) { m_values.reserve(rows); }
+        void push_back(const T& value) { m_values.push_back(value); }
+
+        // getter
+        size_t size() const { return m_values.size(); }
+        const T* data() const { return m_values.data(); }
+        const T& operator[] (size_t row) const { return m_values[row]; }
+
+        // predicates
+        Selection select(Compare op, const T& value) const;
+        Selection between(const T& low, const T& high) const;  // low <= value <= high
+    };
+
+    template <typename T>
+    Selection Column<T>::select(Compare op, const T& value) const
+    {
+        Selection selection{ m_values.size() };
+
+        // the comparison is chosen once per column, not once per row
+        switch (op) {
+        case Compare::Less:
+            FunctionalProgramming_03::select<Compare::Less>(data(), size(), value, selection);
+            break;
+        case Compare::LessEqual:
+            FunctionalProgramming_03::select<Compare::LessEqual>(data(), size(), value, selection);
+            break;
+        case Compare::Greater:
+            FunctionalProgramming_03::select<Compare::Greater>(data(), size(), value, selection);
+            break;
+        case Compare::GreaterEqual:
+            FunctionalProgramming_03::select<Compare::GreaterEqual>(data(), size(), value, selection);
+            break;
+        case Compare::Equal:
+            FunctionalProgramming_03::select<Compare::Equal>(data(), size(), value, selection);
+            break;
+        case Compare::NotEqual:
+            FunctionalProgramming_03::select<Compare::NotEqual>(data(), size(), value, selection);
+            break;
+        }
+
+        return selection;
+    }
+
+    template <typename T>
+    Selection Column<T>::between(const T& low, const T& high) const
+    {
+        return select(Compare::GreaterEqual, low) & select(Compare::LessEqual, high);
+    }
+
+    // =================================================================================
+    // interned strings: every distinct string is stored once, a row holds its id
+
+    class StringPool
+    {
+    private:
+        std::deque<std::string> m_strings;                     // id => string, never relocated
+        std::unordered_map<std::string_view, uint32_t> m_ids;  // string => id, views into 'm_strings'
+
+    public:
+        static constexpr uint32_t NotFound{ std::numeric_limits<uint32_t>::max() };
+
+        uint32_t intern(std::string_view text);
+        uint32_t find(std::string_view text) const;
+
+        // getter
+        size_t size() const { return m_strings.size(); }
+        std::string_view operator[] (uint32_t id) const { return m_strings[id]; }
+    };
+
+    uint32_t StringPool::intern(std::string_view text)
+    {
+        auto pos{ m_ids.find(text) };
+        if (pos != m_ids.end()) {
+            return pos->second;
+        }
+
+        uint32_t id{ static_cast<uint32_t>(m_strings.size()) };
+        m_strings.emplace_back(text);
+        m_ids.emplace(m_strings.back(), id);
+        return id;
+    }
+
+    uint32_t StringPool::find(std::string_view text) const
+    {
+        auto pos{ m_ids.find(text) };
+        return (pos != m_ids.end()) ? pos->second : NotFound;
+    }
+
+    class StringColumn
+    {
+    private:
+        StringPool m_pool;
+        Column<uint32_t> m_ids;
+
+    public:
+        void reserve(size_t rows) { m_ids.reserve(rows); }
+        void push_back(std::string_view text) { m_ids.push_back(m_pool.intern(text)); }
+
+        // getter
+        size_t size() const { return m_ids.size(); }
+        size_t distinct() const { return m_pool.size(); }
+        std::string_view operator[] (size_t row) const { return m_pool[m_ids[row]]; }
+
+        // predicates: the string is looked up once, then only ids are compared
+        Selection equal(std::string_view text) const;
+        Selection notEqual(std::string_view text) const;
+    };
+
+    Selection StringColumn::equal(std::string_view text) const
+    {
+        uint32_t id{ m_pool.find(text) };
+        return (id != StringPool::NotFound)
+            ? m_ids.select(Compare::Equal, id)
+            : Selection{ size() };
+    }
+
+    Selection StringColumn::notEqual(std::string_view text) const
+    {
+        return ~equal(text);
+    }
+
+    // =================================================================================
+    // structure of arrays: one column per member of 'Book'
+
+    class BookTable
+    {
+    private:
+        StringColumn m_titles;
+        StringColumn m_authors;
+        Column<int32_t> m_years;
+        Column<double> m_prices;
+
+    public:
+        // c'tors
+        BookTable() = default;
+        explicit BookTable(const std::vector<Book>& books);
+
+        void reserve(size_t rows);
+        void append(const Book& book);
+
+        // getter
+        size_t size() const { return m_years.size(); }
+        const StringColumn& titles() const { return m_titles; }
+        const StringColumn& authors() const { return m_authors; }
+        const Column<int32_t>& years() const { return m_years; }
+        const Column<double>& prices() const { return m_prices; }
+
+        // late materialization: strings are touched for selected rows only
+        Book row(size_t row) const;
+        std::vector<SearchResult> materialize(const Selection& selection) const;
+    };
+
+    BookTable::BookTable(const std::vector<Book>& books)
+    {
+        reserve(books.size());
+        for (const Book& book : books) {
+            append(book);
+        }
+    }
+
+    void BookTable::reserve(size_t rows)
+    {
+        m_titles.reserve(rows);
+        m_authors.reserve(rows);
+        m_years.reserve(rows);
+        m_prices.reserve(rows);
+    }
+
+    void BookTable::append(const Book& book)
+    {
+        m_titles.push_back(book.m_title);
+        m_authors.push_back(book.m_author);
+        m_years.push_back(book.m_year);
+        m_prices.push_back(book.m_price);
+    }
+
+    Book BookTable::row(size_t row) const
+    {
+        return {
+            std::string{ m_titles[row] },
+            std::string{ m_authors[row] },
+            m_years[row],
+            m_prices[row]
+        };
+    }
+
+    std::vector<SearchResult> BookTable::materialize(const Selection& selection) const
+    {
+        std::vector<SearchResult> result;
+        result.reserve(selection.count());
+
+        selection.forEach([&](size_t row) {
+            result.push_back({ std::string{ m_titles[row] }, std::string{ m_authors[row] } });
+        });
+
+        return result;
+    }
+
+    // sum of a column over the selected rows
+    template <typename T>
+    T sum(const Column<T>& column, const Selection& selection)
+    {
+        T result{};
+        selection.forEach([&](size_t row) { result += column[row]; });
+        return result;
+    }
+
+    // =================================================================================
+    // testing columnar filters
+
+    void test_functional_columnar_01() {
+
+        std::vector<Book> booksList{
+            {"C", "Dennis Ritchie", 1972, 11.99 } ,
+            {"Java", "James Gosling", 1995, 19.99 },
+            {"C++", "Bjarne Stroustrup", 1985, 20.00 },
+            {"C#", "Anders Hejlsberg", 2000, 29.99 }
+        };
+
+        BookTable table{ booksList };
+
+        // a) filter books which appeared past 1990
+        Selection selection{ table.years().select(Compare::GreaterEqual, 1990) };
+        std::cout << "Selected: " << selection.count() << " of " << table.size() << std::endl;  // 2 of 4
+
+        // b) materialize only the selected rows
+        for (const SearchResult& result : table.materialize(selection)) {
+            std::cout << result.m_title << " [" << result.m_author << "]" << std::endl;
+        }
+
+        // combined predicates: past 1980 and cheaper than 25.00
+        selection = table.years().select(Compare::Greater, 1980) & table.prices().select(Compare::Less, 25.0);
+        std::cout << "Sum of prices: " << sum(table.prices(), selection) << std::endl;  // 39.99
+
+        // interned strings: one lookup, then only ids are compared
+        selection = table.authors().equal("Bjarne Stroustrup");
+        selection.forEach([&](size_t row) {
+            std::cout << table.titles()[row] << " (" << table.years()[row] << ")" << std::endl;  // C++ (1985)
+        });
+
+        std::cout << "Not by Dennis Ritchie: " << table.authors().notEqual("Dennis Ritchie").count() << std::endl;  // 3
+    }
+
+    void test_functional_columnar_02() {
+
+        // more rows than bits in a word: full blocks and a partial block
+        std::vector<Book> booksList;
+        for (int i{}; i != 150; ++i) {
+            booksList.push_back({ "Title " + std::to_string(i), "Author " + std::to_string(i % 3), 1900 + i, 1.0 * i });
+        }
+
+        BookTable table{ booksList };
+
+        const Compare operators[]{
+            Compare::Less, Compare::LessEqual, Compare::Greater,
+            Compare::GreaterEqual, Compare::Equal, Compare::NotEqual
+        };
+
+        bool ok{ true };
+        for (Compare op : operators) {
+            Selection years{ table.years().select(op, 1970) };
+            Selection prices{ table.prices().select(op, 100.0) };
+
+            for (size_t row{}; row != table.size(); ++row) {
+                bool year{}, price{};
+                switch (op) {
+                case Compare::Less:         year = booksList[row].m_year < 1970;  price = booksList[row].m_price < 100.0;  break;
+                case Compare::LessEqual:    year = booksList[row].m_year <= 1970; price = booksList[row].m_price <= 100.0; break;
+                case Compare::Greater:      year = booksList[row].m_year > 1970;  price = booksList[row].m_price > 100.0;  break;
+                case Compare::GreaterEqual: year = booksList[row].m_year >= 1970; price = booksList[row].m_price >= 100.0; break;
+                case Compare::Equal:        year = booksList[row].m_year == 1970; price = booksList[row].m_price == 100.0; break;
+                case Compare::NotEqual:     year = booksList[row].m_year != 1970; price = booksList[row].m_price != 100.0; break;
+                }
+                ok = ok && years.test(row) == year && prices.test(row) == price;
+            }
+        }
+
+        ok = ok && table.years().between(1950, 1959).count() == 10;
+        ok = ok && table.authors().equal("Author 1").count() == 50;
+        ok = ok && table.authors().equal("Unknown").count() == 0;
+        ok = ok && (~table.authors().equal("Unknown")).count() == 150;
+        ok = ok && table.authors().distinct() == 3;
+
+        std::cout << "Columnar predicates: " << (ok ? "ok" : "FAILED") << std::endl;
+    }
+
+    // tens of millions of rows are the target, the array of structures for
+    // the comparison needs about 80 bytes per row, therefore 10 millions here
+    constexpr size_t BenchmarkRows{ 10000000 };
+
+    void test_functional_columnar_03_benchmark() {
+
+        std::cout << "Array of structures vs. columnar table (" << BenchmarkRows << " books):" << std::endl;
+
+        std::vector<Book> booksList;
+        booksList.reserve(BenchmarkRows);
+        for (size_t i{}; i != BenchmarkRows; ++i) {
+            booksList.push_back({ "Title " + std::to_string(i % 1000), "Author " + std::to_string(i % 100),
+                1950 + static_cast<int>(i % 70), 0.5 * (i % 100) });
+        }
+
+        BookTable table{ booksList };
+
+        Benchmarking::Options options{};
+        options.minRuns = 3;
+
+        // filter only
+        size_t aosCount{};
+        Benchmarking::print(std::cout, "AoS: count", Benchmarking::measure([&]() {
+            aosCount = std::count_if(std::begin(booksList), std::end(booksList),
+                [](const Book& book) { return book.m_year >= 2015 && book.m_price < 25.0; }
+            );
+        }, options));
+
+        size_t soaCount{};
+        Benchmarking::print(std::cout, "SoA: select, count", Benchmarking::measure([&]() {
+            Selection selection{
+                table.years().select(Compare::GreaterEqual, 2015) & table.prices().select(Compare::Less, 25.0)
+            };
+            soaCount = selection.count();
+        }, options));
+
+        std::cout << "Results: " << aosCount << " / " << soaCount << std::endl;
+
+        // filter and map to 'SearchResult'
+        std::vector<SearchResult> aosResults;
+        Benchmarking::print(std::cout, "AoS: filter, map", Benchmarking::measure([&]() {
+            aosResults.clear();
+            for (const Book& book : booksList) {
+                if (book.m_year >= 2015 && book.m_price < 25.0) {
+                    aosResults.push_back({ book.m_title, book.m_author });
+                }
+            }
+        }, options));
+
+        std::vector<SearchResult> soaResults;
+        Benchmarking::print(std::cout, "SoA: select, materialize", Benchmarking::measure([&]() {
+            Selection selection{
+                table.years().select(Compare::GreaterEqual, 2015) & table.prices().select(Compare::Less, 25.0)
+            };
+            soaResults = table.materialize(selection);
+        }, options));
+
+        std::cout << "Results: " << aosResults.size() << " / " << soaResults.size() << std::endl;
+
+        // string predicate
+        size_t aosAuthors{};
+        Benchmarking::print(std::cout, "AoS: author == ...", Benchmarking::measure([&]() {
+            aosAuthors = std::count_if(std::begin(booksList), std::end(booksList),
+                [](const Book& book) { return book.m_author == "Author 42"; }
+            );
+        }, options));
+
+        size_t soaAuthors{};
+        Benchmarking::print(std::cout, "SoA: interned author == ...", Benchmarking::measure([&]() {
+            soaAuthors = table.authors().equal("Author 42").count();
+        }, options));
+
+        std::cout << "Results: " << aosAuthors << " / " << soaAuthors << std::endl;
+    }
+}
+
+void main_functional_programming_columnar()
+{
+    using namespace FunctionalProgramming_03;
+
+    test_functional_columnar_01();
+    test_functional_columnar_02();
+    test_functional_columnar_03_benchmark();
+}
+
+// =====================================================================================
+// End-of-File
+// =====================================================================================
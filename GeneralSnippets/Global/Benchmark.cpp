@@ -0,0 +1,242 @@
+// ===============================================================================
+// Benchmark Harness for Performance Comparisons
+// ===============================================================================
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+
+#include "Benchmark.h"
+
+namespace Benchmarking {
+
+    void useCharPointer(const volatile char*) {}
+
+    // ---------------------------------------------------------------------------
+    // statistics of a sorted list of samples
+
+    static double median(const std::vector<double>& sorted)
+    {
+        size_t middle{ sorted.size() / 2 };
+        return (sorted.size() % 2 != 0)
+            ? sorted[middle]
+            : (sorted[middle - 1] + sorted[middle]) / 2.0;
+    }
+
+    // nearest-rank method
+    static double percentile(const std::vector<double>& sorted, double percent)
+    {
+        size_t rank{ static_cast<size_t>(std::ceil(percent / 100.0 * sorted.size())) };
+        return sorted[std::max<size_t>(rank, 1) - 1];
+    }
+
+    static double medianAbsoluteDeviation(const std::vector<double>& sorted, double center)
+    {
+        std::vector<double> deviations(sorted.size());
+        std::transform(sorted.begin(), sorted.end(), deviations.begin(),
+            [=](double sample) { return std::fabs(sample - center); }
+        );
+        std::sort(deviations.begin(), deviations.end());
+        return median(deviations);
+    }
+
+    // ---------------------------------------------------------------------------
+
+    Statistics measure(const std::function<void()>& function, const Options& options)
+    {
+        using Clock = std::chrono::steady_clock;
+
+        // seconds per call, averaged over 'batch' calls
+        auto sample = [&](size_t batch) {
+            auto start{ Clock::now() };
+            for (size_t i{}; i != batch; ++i) {
+                function();
+                clobberMemory();
+            }
+            auto end{ Clock::now() };
+            return std::chrono::duration<double>(end - start).count() / batch;
+        };
+
+        for (size_t i{}; i != options.warmupRuns; ++i) {
+            sample(1);
+        }
+
+        // very short calls are batched, so the clock resolution does not matter
+        double minSampleTime{ std::chrono::duration<double>(options.minSampleTime).count() };
+        size_t batch{ 1 };
+        while (sample(batch) * batch < minSampleTime && batch < (size_t{ 1 } << 24)) {
+            batch *= 2;
+        }
+
+        Statistics statistics{};
+        statistics.batch = batch;
+
+        std::vector<double> samples;
+        std::vector<double> sorted;
+        auto start{ Clock::now() };
+
+        while (true) {
+            samples.push_back(sample(batch));
+
+            if (samples.size() < options.minRuns) {
+                continue;
+            }
+
+            sorted = samples;
+            std::sort(sorted.begin(), sorted.end());
+            statistics.median = median(sorted);
+            statistics.spread = (statistics.median > 0.0)
+                ? medianAbsoluteDeviation(sorted, statistics.median) / statistics.median
+                : 0.0;
+            statistics.stable = statistics.spread <= options.targetSpread;
+
+            if (statistics.stable ||
+                samples.size() >= options.maxRuns ||
+                Clock::now() - start >= options.maxTotalTime) {
+                break;
+            }
+        }
+
+        statistics.runs = sorted.size();
+        statistics.p95 = percentile(sorted, 95.0);
+        statistics.min = sorted.front();
+
+        return statistics;
+    }
+
+    // ---------------------------------------------------------------------------
+
+    double Result::bytesPerSecond() const
+    {
+        return (statistics.median > 0.0) ? bytes / statistics.median : 0.0;
+    }
+
+    Benchmark::Benchmark(const std::string& title, const Options& options)
+        : m_title{ title }, m_options{ options } {}
+
+    void Benchmark::add(const std::string& name, const Setup& setup, const Bytes& bytes)
+    {
+        m_cases.push_back({ name, setup, bytes });
+    }
+
+    void Benchmark::run(const std::vector<size_t>& parameters, std::ostream& os)
+    {
+        os << m_title << ':' << std::endl;
+
+        for (size_t parameter : parameters) {
+            for (const Case& entry : m_cases) {
+
+                // the data of a case lives only while it is measured
+                Statistics statistics{};
+                {
+                    Function function{ entry.setup(parameter) };
+                    statistics = measure(function, m_options);
+                }
+
+                double bytes{ entry.bytes ? entry.bytes(parameter) : 0.0 };
+                m_results.push_back({ entry.name, parameter, bytes, statistics });
+
+                print(os, entry.name + " [" + std::to_string(parameter) + "]", statistics, bytes);
+            }
+        }
+    }
+
+    void Benchmark::writeCsv(std::ostream& os) const
+    {
+        os << "benchmark,case,parameter,runs,batch,median_s,p95_s,min_s,spread,stable,bytes_per_s" << std::endl;
+
+        for (const Result& result : m_results) {
+            const Statistics& statistics{ result.statistics };
+            os << '"' << m_title << "\",\"" << result.name << "\","
+                << result.parameter << ','
+                << statistics.runs << ','
+                << statistics.batch << ','
+                << statistics.median << ','
+                << statistics.p95 << ','
+                << statistics.min << ','
+                << statistics.spread << ','
+                << (statistics.stable ? "true" : "false") << ','
+                << result.bytesPerSecond() << std::endl;
+        }
+    }
+
+    static std::string quoted(const std::string& text)
+    {
+        std::string result{ "\"" };
+        for (char ch : text) {
+            if (ch == '"' || ch == '\\') {
+                result += '\\';
+            }
+            result += ch;
+        }
+        result += '"';
+        return result;
+    }
+
+    void Benchmark::writeJson(std::ostream& os) const
+    {
+        os << "{" << std::endl;
+        os << "  \"benchmark\": " << quoted(m_title) << ',' << std::endl;
+        os << "  \"results\": [" << std::endl;
+
+        for (size_t i{}; i != m_results.size(); ++i) {
+            const Result& result{ m_results[i] };
+            const Statistics& statistics{ result.statistics };
+
+            os << "    { "
+                << "\"case\": " << quoted(result.name) << ", "
+                << "\"parameter\": " << result.parameter << ", "
+                << "\"runs\": " << statistics.runs << ", "
+                << "\"batch\": " << statistics.batch << ", "
+                << "\"median_s\": " << statistics.median << ", "
+                << "\"p95_s\": " << statistics.p95 << ", "
+                << "\"min_s\": " << statistics.min << ", "
+                << "\"spread\": " << statistics.spread << ", "
+                << "\"stable\": " << (statistics.stable ? "true" : "false") << ", "
+                << "\"bytes_per_s\": " << result.bytesPerSecond()
+                << " }" << (i + 1 != m_results.size() ? "," : "") << std::endl;
+        }
+
+        os << "  ]" << std::endl;
+        os << "}" << std::endl;
+    }
+
+    // ---------------------------------------------------------------------------
+
+    std::vector<size_t> powersOfTwo(size_t first, size_t last)
+    {
+        std::vector<size_t> values;
+        for (size_t value{ first }; value != 0 && value <= last; value *= 2) {
+            values.push_back(value);
+        }
+        return values;
+    }
+
+    void print(std::ostream& os, const std::string& label, const Statistics& statistics, double bytes)
+    {
+        std::ios_base::fmtflags flags{ os.flags() };
+        std::streamsize precision{ os.precision() };
+
+        os << std::left << std::setw(32) << label << std::right << std::fixed << std::setprecision(3)
+            << " median " << std::setw(10) << statistics.median * 1e3 << " ms"
+            << ", p95 " << std::setw(10) << statistics.p95 * 1e3 << " ms";
+
+        if (bytes > 0.0 && statistics.median > 0.0) {
+            os << ", " << std::setw(8) << std::setprecision(2) << bytes / statistics.median / 1e9 << " GB/s";
+        }
+
+        os << " (" << statistics.runs << " runs" << (statistics.stable ? "" : ", not stable") << ')' << std::endl;
+
+        os.flags(flags);
+        os.precision(precision);
+    }
+}
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -0,0 +1,132 @@
+// ===============================================================================
+// Benchmark Harness for Performance Comparisons
+// ===============================================================================
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Benchmarking {
+
+    // ---------------------------------------------------------------------------
+    // barriers: the optimizer must neither remove nor reorder the measured code
+
+    void useCharPointer(const volatile char*);  // defined in another translation unit
+
+    // 'value' is treated as if it were read by unknown code
+    template <typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(_MSC_VER)
+        useCharPointer(&reinterpret_cast<const volatile char&>(value));
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : "r,m"(value) : "memory");
+#endif
+    }
+
+    // all pending writes to memory are treated as observable
+    inline void clobberMemory()
+    {
+#if defined(_MSC_VER)
+        _ReadWriteBarrier();
+#else
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    // ---------------------------------------------------------------------------
+    // measuring a single piece of code
+
+    struct Options
+    {
+        size_t warmupRuns{ 1 };
+        size_t minRuns{ 5 };
+        size_t maxRuns{ 100 };
+        double targetSpread{ 0.02 };   // relative median absolute deviation
+        std::chrono::nanoseconds minSampleTime{ std::chrono::milliseconds{ 1 } };  // shorter calls are batched
+        std::chrono::nanoseconds maxTotalTime{ std::chrono::seconds{ 2 } };
+    };
+
+    struct Statistics
+    {
+        size_t runs;       // number of samples
+        size_t batch;      // calls per sample
+        double median;     // seconds per call
+        double p95;        // seconds per call
+        double min;        // seconds per call
+        double spread;     // median absolute deviation / median
+        bool stable;       // 'spread' reached 'targetSpread'
+    };
+
+    // warm-up, then samples are taken until the median is stable
+    Statistics measure(const std::function<void()>& function, const Options& options = Options{});
+
+    // ---------------------------------------------------------------------------
+    // a set of cases, each one measured for a list of parameters (e.g. matrix sizes)
+
+    struct Result
+    {
+        std::string name;
+        size_t parameter;
+        double bytes;      // bytes moved by one call, 0 if unknown
+        Statistics statistics;
+
+        double bytesPerSecond() const;
+    };
+
+    class Benchmark
+    {
+    public:
+        using Function = std::function<void()>;
+        using Setup = std::function<Function(size_t parameter)>;  // prepares data, returns the code to be measured
+        using Bytes = std::function<double(size_t parameter)>;
+
+    private:
+        struct Case
+        {
+            std::string name;
+            Setup setup;
+            Bytes bytes;
+        };
+
+        std::string m_title;
+        Options m_options;
+        std::vector<Case> m_cases;
+        std::vector<Result> m_results;
+
+    public:
+        explicit Benchmark(const std::string& title, const Options& options = Options{});
+
+        void add(const std::string& name, const Setup& setup, const Bytes& bytes = Bytes{});
+
+        // runs every case for every parameter, one line of output per measurement
+        void run(const std::vector<size_t>& parameters, std::ostream& os = std::cout);
+
+        // getter
+        const std::string& title() const { return m_title; }
+        const std::vector<Result>& results() const { return m_results; }
+
+        // export
+        void writeCsv(std::ostream& os) const;
+        void writeJson(std::ostream& os) const;
+    };
+
+    // first, 2 * first, 4 * first, ..., up to last
+    std::vector<size_t> powersOfTwo(size_t first, size_t last);
+
+    // one line: median, p95 and - if known - throughput
+    void print(std::ostream& os, const std::string& label, const Statistics& statistics, double bytes = 0.0);
+}
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -0,0 +1,145 @@
+// ===============================================================================
+// Copy-on-Write Buffer with Atomic Reference Count
+// ===============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+// Copies share one heap block and only increment its reference count.
+// The first mutable access of a shared buffer copies the elements ("detach").
+// Thread safety as for std::shared_ptr: different 'CowBuffer' objects may be
+// used concurrently even if they share a block, one object must not be
+// modified by one thread while another thread accesses it.
+//
+// Copying a buffer invalidates the pointers previously returned by 'mutableData()':
+// the block is shared afterwards, writing through such a pointer would change
+// the copy, too. Call 'mutableData()' again after every copy:
+//
+//     int* p{ a.mutableData() };
+//     CowBuffer<int> b{ a };
+//     p[0] = 5;                 // wrong: changes 'b'
+//     a.mutableData()[0] = 5;   // detaches 'a' first
+
+template <typename T>
+class CowBuffer
+{
+private:
+    static_assert(std::is_trivially_copyable_v<T>, "CowBuffer: elements are copied as bytes");
+
+    struct Block
+    {
+        std::atomic<size_t> m_references;
+        size_t m_size;
+
+        T* data() { return reinterpret_cast<T*>(this + 1); }
+    };
+
+    static_assert(alignof(T) <= alignof(Block), "CowBuffer: elements follow the block header");
+
+    Block* m_block;
+
+public:
+    // c'tors and d'tor
+    CowBuffer() noexcept : m_block{ nullptr } {}
+
+    explicit CowBuffer(size_t size) : m_block{ allocate(size) } {}
+
+    CowBuffer(size_t size, const T& preset) : m_block{ allocate(size) } {
+        std::fill(m_block->data(), m_block->data() + size, preset);
+    }
+
+    ~CowBuffer() {
+        release(m_block);
+    }
+
+    // copy semantics: O(1), the block is shared
+    CowBuffer(const CowBuffer& other) noexcept : m_block{ other.m_block } {
+        if (m_block != nullptr) {
+            m_block->m_references.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    CowBuffer& operator= (const CowBuffer& other) noexcept {
+        CowBuffer copy{ other };
+        swap(copy);
+        return *this;
+    }
+
+    // move semantics
+    CowBuffer(CowBuffer&& other) noexcept : m_block{ other.m_block } {
+        other.m_block = nullptr;
+    }
+
+    CowBuffer& operator= (CowBuffer&& other) noexcept {
+        CowBuffer moved{ std::move(other) };
+        swap(moved);
+        return *this;
+    }
+
+    void swap(CowBuffer& other) noexcept {
+        std::swap(m_block, other.m_block);
+    }
+
+    // getter
+    size_t size() const { return m_block != nullptr ? m_block->m_size : 0; }
+
+    size_t useCount() const {
+        return m_block != nullptr ? m_block->m_references.load(std::memory_order_relaxed) : 0;
+    }
+
+    bool isShared() const { return useCount() > 1; }
+
+    // read access never copies
+    const T* data() const { return m_block != nullptr ? m_block->data() : nullptr; }
+
+    // write access: a shared block is copied first,
+    // the pointer is valid until the buffer is copied
+    T* mutableData() {
+        if (m_block == nullptr) {
+            return nullptr;
+        }
+
+        // 'acquire': writes happen after the reads of former owners of the block
+        if (m_block->m_references.load(std::memory_order_acquire) != 1) {
+            Block* copy{ allocate(m_block->m_size) };
+            std::copy(m_block->data(), m_block->data() + m_block->m_size, copy->data());
+            release(m_block);
+            m_block = copy;
+        }
+        return m_block->data();
+    }
+
+private:
+    static Block* allocate(size_t size) {
+        if (size == 0) {
+            return nullptr;
+        }
+
+        if (size > (static_cast<size_t>(-1) - sizeof(Block)) / sizeof(T)) {
+            throw std::bad_array_new_length{};
+        }
+
+        void* memory{ ::operator new(sizeof(Block) + size * sizeof(T)) };
+        Block* block{ ::new (memory) Block };
+        block->m_references.store(1, std::memory_order_relaxed);
+        block->m_size = size;
+        return block;
+    }
+
+    static void release(Block* block) noexcept {
+        // 'acq_rel': the last owner sees all accesses of the other owners
+        if (block != nullptr && block->m_references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            block->~Block();
+            ::operator delete(block);
+        }
+    }
+};
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -2,40 +2,56 @@
 // Dummy Class for Testing Purposes
 // ===============================================================================
 
+#include "InstanceCounter.h"
+
+// default of the output, regression tests switch it off with 'Dummy::setVerbose'
+// and check the numbers of 'InstanceCounter<Dummy>' instead
 constexpr bool isVerbose = true;
 
 class Dummy
 {
 private:
     int m_dummy;
+
+    static inline bool s_verbose{ isVerbose };
+
 public:
     explicit Dummy() : m_dummy (0){
-        if (isVerbose) {
+        InstanceCounter<Dummy>::count(Operation::DefaultConstruct);
+        if (s_verbose) {
             std::cout << "c'tor Dummy [" << m_dummy << "]" << std::endl;
         }
     }
 
     explicit Dummy(int dummy) : m_dummy(dummy) {
-        if (isVerbose) {
+        InstanceCounter<Dummy>::count(Operation::ValueConstruct);
+        if (s_verbose) {
             std::cout << "c'tor Dummy [" << m_dummy << "]" << std::endl;
         }
     }
 
     // "Big-Three"
     ~Dummy() {
-        if (isVerbose) {
+        InstanceCounter<Dummy>::count(Operation::Destruct);
+        if (s_verbose) {
             std::cout << "d'tor Dummy [" << m_dummy << "]" << std::endl;
         }
     }
 
     Dummy(const Dummy& other) {
         m_dummy = other.m_dummy;
-        std::cout << "Copy-c'tor Dummy [" << m_dummy << "]" << std::endl;
+        InstanceCounter<Dummy>::count(Operation::CopyConstruct);
+        if (s_verbose) {
+            std::cout << "Copy-c'tor Dummy [" << m_dummy << "]" << std::endl;
+        }
     }
 
     Dummy& operator=(Dummy const& other) {
         m_dummy = other.m_dummy;
-        std::cout << "Dummy::operator=" << std::endl;
+        InstanceCounter<Dummy>::count(Operation::CopyAssign);
+        if (s_verbose) {
+            std::cout << "Dummy::operator=" << std::endl;
+        }
         return *this;
     }
 
@@ -43,7 +59,10 @@ public:
     Dummy(Dummy&& other) noexcept {
         m_dummy = other.m_dummy;  // move ownership to target 
         other.m_dummy = 0;        // reset source (symbolic statement)
-        std::cout << "Move c'tor Dummy" << std::endl;
+        InstanceCounter<Dummy>::count(Operation::MoveConstruct);
+        if (s_verbose) {
+            std::cout << "Move c'tor Dummy" << std::endl;
+        }
     }
 
     Dummy& operator=(Dummy&& other) noexcept {
@@ -54,7 +73,10 @@ public:
 
         m_dummy = other.m_dummy;  // move ownership to target 
         other.m_dummy = 0;        // reset source (symbolic statement)
-        std::cout << "Move Dummy::operator=" << std::endl;
+        InstanceCounter<Dummy>::count(Operation::MoveAssign);
+        if (s_verbose) {
+            std::cout << "Move Dummy::operator=" << std::endl;
+        }
         return *this;
     }
 
@@ -67,10 +89,23 @@ public:
         std::cout << "Hello Dummy [" << m_dummy << "]" << std::endl;
     }
 
+    // output of the special member functions, counting is always on
+    static void setVerbose(bool verbose) {
+        s_verbose = verbose;
+    }
+
+    static bool verbose() {
+        return s_verbose;
+    }
+
     // output
     friend std::ostream& operator<< (std::ostream&, const Dummy&);
 };
 
+// note: 'Dummy' is deliberately not trivially relocatable ('is_trivially_relocatable').
+// Its move c'tor and d'tor are observed (output, 'InstanceCounter'), a container
+// must call them element by element - memcpy relocation would hide them
+
 // ===============================================================================
 // End-of-File
 // ===============================================================================
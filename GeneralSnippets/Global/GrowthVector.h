@@ -0,0 +1,457 @@
+// ===============================================================================
+// Vector with Growth Policies, Capacity Hints and Relocation by memcpy
+// ===============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <algorithm>
+#include <functional>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "TriviallyRelocatable.h"
+
+// ---------------------------------------------------------------------------
+// growth policies: new capacity when 'capacity' is too small for 'required' elements
+
+template <size_t Numerator, size_t Denominator>
+struct GeometricGrowth {
+    static_assert(Numerator > Denominator, "growth factor must be greater than 1");
+
+    static size_t next(size_t capacity, size_t required) {
+        size_t grown{ capacity + capacity / Denominator * (Numerator - Denominator) };
+        return std::max({ grown, required, size_t{ 4 } });
+    }
+};
+
+using DoublingGrowth = GeometricGrowth<2, 1>;   // GCC and Clang
+using GoldenGrowth = GeometricGrowth<3, 2>;     // factor 1.5, MSVC
+
+// constant step: little slack, but O(n^2) copying
+template <size_t Step>
+struct LinearGrowth {
+    static size_t next(size_t capacity, size_t required) {
+        return std::max(capacity + Step, required);
+    }
+};
+
+// element types which may be moved by 'std::realloc' and 'std::memmove': the bytes are the object
+template <typename T>
+constexpr bool IsReallocatable = is_trivially_relocatable_v<T> && alignof(T) <= alignof(std::max_align_t);
+
+// ---------------------------------------------------------------------------
+// capacity hints: the largest size reached at one call site so far;
+// the next container created there reserves it up front
+
+class CapacityHint
+{
+private:
+    std::atomic<size_t> m_capacity;
+
+public:
+    CapacityHint() : m_capacity{} {}
+
+    size_t capacity() const { return m_capacity.load(std::memory_order_relaxed); }
+
+    void record(size_t size) {
+        size_t capacity{ m_capacity.load(std::memory_order_relaxed) };
+        while (size > capacity && !m_capacity.compare_exchange_weak(capacity, size, std::memory_order_relaxed)) {
+        }
+    }
+};
+
+// ---------------------------------------------------------------------------
+// vector with a pluggable growth policy;
+// trivially relocatable elements live in 'std::malloc' memory and grow with 'std::realloc',
+// which may extend the block in place (glibc uses 'mremap' for large blocks),
+// 'insert' and 'erase' shift them with one 'std::memmove' instead of element-wise moves
+
+template <typename T, typename TGrowth = DoublingGrowth>
+class GrowthVector
+{
+private:
+    T* m_data;
+    size_t m_size;
+    size_t m_capacity;
+    size_t m_reallocations;
+    CapacityHint* m_hint;
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // c'tors and d'tor
+    GrowthVector();
+    explicit GrowthVector(CapacityHint& hint);
+    GrowthVector(const GrowthVector& other);
+    GrowthVector(GrowthVector&& other) noexcept;
+    ~GrowthVector();
+
+    // copy-and-swap
+    GrowthVector& operator= (GrowthVector other) noexcept;
+
+    void swap(GrowthVector& other) noexcept;
+
+    // modifiers
+    template <typename... TArgs>
+    T& emplace_back(TArgs&&... args);
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    iterator insert(const_iterator position, const T& value);
+    iterator insert(const_iterator position, T&& value);
+
+    template <typename... TArgs>
+    iterator emplace(const_iterator position, TArgs&&... args);
+
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+
+    void pop_back();
+    void clear();
+    void reserve(size_t capacity);
+    void shrink_to_fit();
+
+    // getter
+    size_t size() const { return m_size; }
+    size_t capacity() const { return m_capacity; }
+    size_t reallocations() const { return m_reallocations; }
+    bool empty() const { return m_size == 0; }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+
+    T& operator[] (size_t index) { return m_data[index]; }
+    const T& operator[] (size_t index) const { return m_data[index]; }
+
+    T& front() { return m_data[0]; }
+    const T& front() const { return m_data[0]; }
+    T& back() { return m_data[m_size - 1]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+
+private:
+    void reallocate(size_t capacity);
+    void destroyAll();
+
+    // true, if one of the arguments lies inside the elements (e.g. 'push_back(vec[0])')
+    template <typename... TArgs>
+    bool refersToElement(const TArgs&... args) const;
+
+    static T* allocate(size_t capacity);
+    static void deallocate(T* data);
+};
+
+// c'tors and d'tor
+template <typename T, typename TGrowth>
+GrowthVector<T, TGrowth>::GrowthVector()
+    : m_data{}, m_size{}, m_capacity{}, m_reallocations{}, m_hint{} {}
+
+template <typename T, typename TGrowth>
+GrowthVector<T, TGrowth>::GrowthVector(CapacityHint& hint)
+    : m_data{}, m_size{}, m_capacity{}, m_reallocations{}, m_hint{ &hint }
+{
+    reserve(hint.capacity());
+}
+
+template <typename T, typename TGrowth>
+GrowthVector<T, TGrowth>::GrowthVector(const GrowthVector& other)
+    : m_data{}, m_size{}, m_capacity{}, m_reallocations{}, m_hint{ other.m_hint }
+{
+    if (other.m_size == 0) {
+        return;
+    }
+
+    m_data = allocate(other.m_size);
+    try {
+        std::uninitialized_copy(other.begin(), other.end(), m_data);
+    }
+    catch (...) {
+        deallocate(m_data);
+        throw;
+    }
+    m_size = m_capacity = other.m_size;
+}
+
+template <typename T, typename TGrowth>
+GrowthVector<T, TGrowth>::GrowthVector(GrowthVector&& other) noexcept
+    : m_data{ other.m_data }, m_size{ other.m_size }, m_capacity{ other.m_capacity },
+      m_reallocations{ other.m_reallocations }, m_hint{ other.m_hint }
+{
+    other.m_data = nullptr;
+    other.m_size = other.m_capacity = other.m_reallocations = 0;
+    other.m_hint = nullptr;
+}
+
+template <typename T, typename TGrowth>
+GrowthVector<T, TGrowth>::~GrowthVector()
+{
+    if (m_hint != nullptr) {
+        m_hint->record(m_size);
+    }
+
+    destroyAll();
+    deallocate(m_data);
+}
+
+template <typename T, typename TGrowth>
+GrowthVector<T, TGrowth>& GrowthVector<T, TGrowth>::operator= (GrowthVector other) noexcept
+{
+    swap(other);
+    return *this;
+}
+
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::swap(GrowthVector& other) noexcept
+{
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_capacity, other.m_capacity);
+    std::swap(m_reallocations, other.m_reallocations);
+    std::swap(m_hint, other.m_hint);
+}
+
+// modifiers
+template <typename T, typename TGrowth>
+template <typename... TArgs>
+T& GrowthVector<T, TGrowth>::emplace_back(TArgs&&... args)
+{
+    if (m_size == m_capacity && refersToElement(args...)) {
+        // construct before the old buffer is released
+        T value(std::forward<TArgs>(args)...);
+        reallocate(TGrowth::next(m_capacity, m_size + 1));
+        ::new (static_cast<void*>(m_data + m_size)) T(std::move(value));
+    }
+    else {
+        if (m_size == m_capacity) {
+            reallocate(TGrowth::next(m_capacity, m_size + 1));
+        }
+        ::new (static_cast<void*>(m_data + m_size)) T(std::forward<TArgs>(args)...);
+    }
+
+    return m_data[m_size++];
+}
+
+template <typename T, typename TGrowth>
+typename GrowthVector<T, TGrowth>::iterator GrowthVector<T, TGrowth>::insert(const_iterator position, const T& value)
+{
+    return emplace(position, value);
+}
+
+template <typename T, typename TGrowth>
+typename GrowthVector<T, TGrowth>::iterator GrowthVector<T, TGrowth>::insert(const_iterator position, T&& value)
+{
+    return emplace(position, std::move(value));
+}
+
+template <typename T, typename TGrowth>
+template <typename... TArgs>
+typename GrowthVector<T, TGrowth>::iterator GrowthVector<T, TGrowth>::emplace(const_iterator position, TArgs&&... args)
+{
+    size_t index{ static_cast<size_t>(position - m_data) };
+
+    if constexpr (IsReallocatable<T>) {
+        if (refersToElement(args...)) {
+            // construct before any element is shifted
+            T value(std::forward<TArgs>(args)...);
+            return emplace(position, std::move(value));
+        }
+
+        if (m_size == m_capacity) {
+            reallocate(TGrowth::next(m_capacity, m_size + 1));
+        }
+
+        // one gap, opened by shifting the bytes of the tail
+        std::memmove(static_cast<void*>(m_data + index + 1), static_cast<const void*>(m_data + index), (m_size - index) * sizeof(T));
+        try {
+            ::new (static_cast<void*>(m_data + index)) T(std::forward<TArgs>(args)...);
+        }
+        catch (...) {
+            std::memmove(static_cast<void*>(m_data + index), static_cast<const void*>(m_data + index + 1), (m_size - index) * sizeof(T));
+            throw;
+        }
+        ++m_size;
+    }
+    else {
+        // like std::vector: append, then rotate into place
+        emplace_back(std::forward<TArgs>(args)...);
+        std::rotate(m_data + index, m_data + m_size - 1, m_data + m_size);
+    }
+
+    return m_data + index;
+}
+
+template <typename T, typename TGrowth>
+typename GrowthVector<T, TGrowth>::iterator GrowthVector<T, TGrowth>::erase(const_iterator position)
+{
+    return erase(position, position + 1);
+}
+
+template <typename T, typename TGrowth>
+typename GrowthVector<T, TGrowth>::iterator GrowthVector<T, TGrowth>::erase(const_iterator first, const_iterator last)
+{
+    size_t index{ static_cast<size_t>(first - m_data) };
+    size_t count{ static_cast<size_t>(last - first) };
+
+    if (count == 0) {
+        return m_data + index;
+    }
+
+    if constexpr (IsReallocatable<T>) {
+        // destroy the erased elements, close the gap with the bytes of the tail
+        std::destroy(m_data + index, m_data + index + count);
+        std::memmove(static_cast<void*>(m_data + index), static_cast<const void*>(m_data + index + count), (m_size - index - count) * sizeof(T));
+    }
+    else {
+        std::move(m_data + index + count, m_data + m_size, m_data + index);
+        std::destroy(m_data + m_size - count, m_data + m_size);
+    }
+
+    m_size -= count;
+    return m_data + index;
+}
+
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::pop_back()
+{
+    --m_size;
+    m_data[m_size].~T();
+}
+
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::clear()
+{
+    destroyAll();
+    m_size = 0;
+}
+
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::reserve(size_t capacity)
+{
+    if (capacity > m_capacity) {
+        reallocate(capacity);
+    }
+}
+
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::shrink_to_fit()
+{
+    if (m_capacity > m_size) {
+        reallocate(m_size);
+    }
+}
+
+// new buffer of 'capacity' elements, 'capacity' >= 'm_size'
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::reallocate(size_t capacity)
+{
+    if (capacity > static_cast<size_t>(-1) / sizeof(T)) {
+        throw std::length_error{ "GrowthVector: capacity too large" };
+    }
+
+    if constexpr (IsReallocatable<T>) {
+        if (capacity == 0) {
+            std::free(m_data);
+            m_data = nullptr;
+        }
+        else {
+            void* data{ std::realloc(static_cast<void*>(m_data), capacity * sizeof(T)) };
+            if (data == nullptr) {
+                throw std::bad_alloc{};
+            }
+            m_data = static_cast<T*>(data);
+        }
+    }
+    else {
+        T* data{ allocate(capacity) };
+
+        // like std::vector: elements are copied if moving might throw
+        size_t count{};
+        try {
+            for (; count != m_size; ++count) {
+                ::new (static_cast<void*>(data + count)) T(std::move_if_noexcept(m_data[count]));
+            }
+        }
+        catch (...) {
+            std::destroy(data, data + count);
+            deallocate(data);
+            throw;
+        }
+
+        destroyAll();
+        deallocate(m_data);
+        m_data = data;
+    }
+
+    if (m_capacity != 0) {
+        ++m_reallocations;
+    }
+    m_capacity = capacity;
+}
+
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::destroyAll()
+{
+    std::destroy(m_data, m_data + m_size);
+}
+
+template <typename T, typename TGrowth>
+template <typename... TArgs>
+bool GrowthVector<T, TGrowth>::refersToElement(const TArgs&... args) const
+{
+    auto inside = [this](const void* address) {
+        const char* first{ reinterpret_cast<const char*>(m_data) };
+        const char* last{ reinterpret_cast<const char*>(m_data + m_size) };
+        const char* pointer{ static_cast<const char*>(address) };
+        return !std::less<const char*>{}(pointer, first) && std::less<const char*>{}(pointer, last);
+    };
+
+    return (inside(std::addressof(args)) || ...);
+}
+
+template <typename T, typename TGrowth>
+T* GrowthVector<T, TGrowth>::allocate(size_t capacity)
+{
+    if (capacity == 0) {
+        return nullptr;
+    }
+
+    if constexpr (IsReallocatable<T>) {
+        void* data{ std::malloc(capacity * sizeof(T)) };
+        if (data == nullptr) {
+            throw std::bad_alloc{};
+        }
+        return static_cast<T*>(data);
+    }
+    else {
+        return static_cast<T*>(::operator new(capacity * sizeof(T)));
+    }
+}
+
+template <typename T, typename TGrowth>
+void GrowthVector<T, TGrowth>::deallocate(T* data)
+{
+    if constexpr (IsReallocatable<T>) {
+        std::free(data);
+    }
+    else {
+        ::operator delete(data);
+    }
+}
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
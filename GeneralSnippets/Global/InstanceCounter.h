@@ -0,0 +1,224 @@
+// ===============================================================================
+// Instance Counters: Counting Constructions, Copies, Moves and Destructions
+// ===============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <string>
+
+// A class counts its special member functions with 'InstanceCounter<T>::count':
+//
+//     MyClass(const MyClass& other) { InstanceCounter<MyClass>::count(Operation::CopyConstruct); }
+//
+// A 'CountingScope<T>' takes a snapshot on construction, 'counts()' returns the
+// operations since then. The 'expect_...' helpers compare these numbers with the
+// expectation of a scenario, print the result and return 'false' on a mismatch:
+// an extra copy in an allocator, forwarding or move scenario becomes visible
+// without reading pages of c'tor output. A 'RegressionCheck<T>' collects these
+// results, a failed check makes 'main' return a non-zero exit code.
+
+enum class Operation
+{
+    DefaultConstruct, ValueConstruct, CopyConstruct, MoveConstruct, CopyAssign, MoveAssign, Destruct
+};
+
+struct InstanceCounts
+{
+    size_t defaultConstructed{};
+    size_t valueConstructed{};
+    size_t copyConstructed{};
+    size_t moveConstructed{};
+    size_t copyAssigned{};
+    size_t moveAssigned{};
+    size_t destructed{};
+
+    size_t constructed() const {
+        return defaultConstructed + valueConstructed + copyConstructed + moveConstructed;
+    }
+
+    size_t copies() const { return copyConstructed + copyAssigned; }
+    size_t moves() const { return moveConstructed + moveAssigned; }
+};
+
+inline InstanceCounts operator- (const InstanceCounts& lhs, const InstanceCounts& rhs)
+{
+    return {
+        lhs.defaultConstructed - rhs.defaultConstructed,
+        lhs.valueConstructed - rhs.valueConstructed,
+        lhs.copyConstructed - rhs.copyConstructed,
+        lhs.moveConstructed - rhs.moveConstructed,
+        lhs.copyAssigned - rhs.copyAssigned,
+        lhs.moveAssigned - rhs.moveAssigned,
+        lhs.destructed - rhs.destructed
+    };
+}
+
+inline std::ostream& operator<< (std::ostream& os, const InstanceCounts& counts)
+{
+    os << "c'tors: " << counts.defaultConstructed << '+' << counts.valueConstructed
+        << ", copies: " << counts.copyConstructed << '+' << counts.copyAssigned
+        << ", moves: " << counts.moveConstructed << '+' << counts.moveAssigned
+        << ", d'tors: " << counts.destructed;
+    return os;
+}
+
+// one set of counters per type;
+// 'relaxed': the counters order nothing, they are read after the threads are joined
+template <typename T>
+class InstanceCounter
+{
+private:
+    static inline std::atomic<size_t> s_counts[static_cast<size_t>(Operation::Destruct) + 1]{};
+
+public:
+    static void count(Operation operation) noexcept {
+        s_counts[static_cast<size_t>(operation)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static InstanceCounts snapshot() noexcept {
+        return {
+            load(Operation::DefaultConstruct),
+            load(Operation::ValueConstruct),
+            load(Operation::CopyConstruct),
+            load(Operation::MoveConstruct),
+            load(Operation::CopyAssign),
+            load(Operation::MoveAssign),
+            load(Operation::Destruct)
+        };
+    }
+
+private:
+    static size_t load(Operation operation) noexcept {
+        return s_counts[static_cast<size_t>(operation)].load(std::memory_order_relaxed);
+    }
+};
+
+template <typename T>
+class CountingScope
+{
+private:
+    InstanceCounts m_start;
+
+public:
+    CountingScope() noexcept : m_start{ InstanceCounter<T>::snapshot() } {}
+
+    // operations since the construction of the scope
+    InstanceCounts counts() const noexcept {
+        return InstanceCounter<T>::snapshot() - m_start;
+    }
+};
+
+// ===============================================================================
+// expectations
+
+inline bool expect(bool condition, const char* scenario, const InstanceCounts& counts, const std::string& expectation)
+{
+    std::cout << (condition ? "ok     " : "FAILED ") << scenario << " - " << counts;
+    if (!condition) {
+        std::cout << "  <== expected " << expectation;
+    }
+    std::cout << std::endl;
+    return condition;
+}
+
+inline bool expect_no_copies(const InstanceCounts& counts, const char* scenario)
+{
+    return expect(counts.copies() == 0, scenario, counts, "no copies");
+}
+
+inline bool expect_copies(const InstanceCounts& counts, size_t copies, const char* scenario)
+{
+    return expect(counts.copies() == copies, scenario, counts, std::to_string(copies) + " copies");
+}
+
+inline bool expect_moves(const InstanceCounts& counts, size_t moves, const char* scenario)
+{
+    return expect(counts.moves() == moves, scenario, counts, std::to_string(moves) + " moves");
+}
+
+inline bool expect_copies_and_moves(const InstanceCounts& counts, size_t copies, size_t moves, const char* scenario)
+{
+    return expect(counts.copies() == copies && counts.moves() == moves, scenario, counts,
+        std::to_string(copies) + " copies and " + std::to_string(moves) + " moves");
+}
+
+// no copies and no moves: objects are constructed in place
+inline bool expect_in_place(const InstanceCounts& counts, const char* scenario)
+{
+    return expect(counts.copies() == 0 && counts.moves() == 0, scenario, counts, "construction in place");
+}
+
+// every object constructed in the scope has been destroyed
+inline bool expect_balanced(const InstanceCounts& counts, const char* scenario)
+{
+    return expect(counts.constructed() == counts.destructed, scenario, counts, "as many d'tors as c'tors");
+}
+
+// ===============================================================================
+// regression check: mutes the output of 'T' ('T::setVerbose') for its lifetime,
+// records the results of the 'expect_...' helpers and reports in its d'tor.
+// Failed checks are counted process-wide and stop Debug builds (assert)
+
+inline std::atomic<size_t>& regressionFailureCounter()
+{
+    static std::atomic<size_t> failures{};
+    return failures;
+}
+
+inline size_t regressionFailures()
+{
+    return regressionFailureCounter().load(std::memory_order_relaxed);
+}
+
+template <typename T>
+class RegressionCheck
+{
+private:
+    const char* m_name;
+    bool m_verbose;
+    bool m_passed;
+    CountingScope<T> m_total;
+
+public:
+    // c'tor and d'tor
+    explicit RegressionCheck(const char* name)
+        : m_name{ name }, m_verbose{ T::verbose() }, m_passed{ true }, m_total{}
+    {
+        T::setVerbose(false);
+    }
+
+    ~RegressionCheck()
+    {
+        // all objects of the scenarios are destroyed before the check itself
+        (*this)(expect_balanced(m_total.counts(), "all scenarios"));
+
+        T::setVerbose(m_verbose);
+        std::cout << m_name << ": "
+            << (m_passed ? "no regressions" : "REGRESSION - unexpected c'tor calls, copies or moves") << std::endl;
+        assert(m_passed);
+    }
+
+    RegressionCheck(const RegressionCheck&) = delete;
+    RegressionCheck& operator= (const RegressionCheck&) = delete;
+
+    // records the result of an 'expect_...' helper
+    bool operator() (bool passed)
+    {
+        if (!passed) {
+            m_passed = false;
+            regressionFailureCounter().fetch_add(1, std::memory_order_relaxed);
+        }
+        return passed;
+    }
+
+    // getter
+    bool passed() const { return m_passed; }
+};
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -0,0 +1,195 @@
+// ===============================================================================
+// Large Buffers Directly from the Operating System (mmap / VirtualAlloc)
+// ===============================================================================
+
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <utility>
+
+#include "MappedMemory.h"
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace MappedMemory {
+
+    // ---------------------------------------------------------------------------
+    // operating system interface
+
+#if defined(_WIN32)
+
+    size_t pageSize()
+    {
+        SYSTEM_INFO info{};
+        ::GetSystemInfo(&info);
+        return info.dwPageSize;
+    }
+
+    static void* map(size_t bytes, PageSize)
+    {
+        // large pages need the 'SeLockMemoryPrivilege', normal pages are used instead
+        void* address{ ::VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE) };
+        if (address == nullptr) {
+            throw std::bad_alloc{};
+        }
+        return address;
+    }
+
+    static void unmap(void* address, size_t)
+    {
+        ::VirtualFree(address, 0, MEM_RELEASE);
+    }
+
+    static void* remap(void* address, size_t oldBytes, size_t newBytes, PageSize pageSize)
+    {
+        void* moved{ map(newBytes, pageSize) };
+        std::memcpy(moved, address, std::min(oldBytes, newBytes));
+        unmap(address, oldBytes);
+        return moved;
+    }
+
+#elif defined(__linux__)
+
+    size_t pageSize()
+    {
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    }
+
+    static void adviseHugePages(void* address, size_t bytes, PageSize pageSize)
+    {
+        if (pageSize == PageSize::Huge) {
+            ::madvise(address, bytes, MADV_HUGEPAGE);  // a hint, failure is not an error
+        }
+    }
+
+    static void* map(size_t bytes, PageSize pageSize)
+    {
+        void* address{ ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) };
+        if (address == MAP_FAILED) {
+            throw std::bad_alloc{};
+        }
+        adviseHugePages(address, bytes, pageSize);
+        return address;
+    }
+
+    static void unmap(void* address, size_t bytes)
+    {
+        ::munmap(address, bytes);
+    }
+
+    static void* remap(void* address, size_t oldBytes, size_t newBytes, PageSize pageSize)
+    {
+        // mremap keeps whole pages: clear the tail of the last page kept,
+        // otherwise growing again would bring back the old contents
+        if (newBytes < oldBytes) {
+            size_t page{ MappedMemory::pageSize() };
+            size_t pageEnd{ std::min(oldBytes, (newBytes + page - 1) / page * page) };
+            std::memset(static_cast<char*>(address) + newBytes, 0, pageEnd - newBytes);
+        }
+
+        void* moved{ ::mremap(address, oldBytes, newBytes, MREMAP_MAYMOVE) };
+        if (moved == MAP_FAILED) {
+            throw std::bad_alloc{};
+        }
+        adviseHugePages(moved, newBytes, pageSize);
+        return moved;
+    }
+
+#else
+
+    size_t pageSize()
+    {
+        return 4096;
+    }
+
+    static void* map(size_t bytes, PageSize)
+    {
+        void* address{ ::operator new(bytes) };
+        std::memset(address, 0, bytes);
+        return address;
+    }
+
+    static void unmap(void* address, size_t)
+    {
+        ::operator delete(address);
+    }
+
+    static void* remap(void* address, size_t oldBytes, size_t newBytes, PageSize pageSize)
+    {
+        void* moved{ map(newBytes, pageSize) };
+        std::memcpy(moved, address, std::min(oldBytes, newBytes));
+        unmap(address, oldBytes);
+        return moved;
+    }
+
+#endif
+
+    // ---------------------------------------------------------------------------
+    // c'tors and d'tor
+
+    Mapping::Mapping() noexcept : m_address{ nullptr }, m_bytes{ 0 }, m_pageSize{ PageSize::Normal } {}
+
+    Mapping::Mapping(size_t bytes, PageSize pageSize)
+        : m_address{ bytes != 0 ? map(bytes, pageSize) : nullptr }, m_bytes{ bytes }, m_pageSize{ pageSize } {}
+
+    Mapping::~Mapping()
+    {
+        release();
+    }
+
+    Mapping::Mapping(Mapping&& other) noexcept
+        : m_address{ other.m_address }, m_bytes{ other.m_bytes }, m_pageSize{ other.m_pageSize }
+    {
+        other.m_address = nullptr;
+        other.m_bytes = 0;
+    }
+
+    Mapping& Mapping::operator= (Mapping&& other) noexcept
+    {
+        if (this != &other) {
+            release();
+            m_address = std::exchange(other.m_address, nullptr);
+            m_bytes = std::exchange(other.m_bytes, 0);
+            m_pageSize = other.m_pageSize;
+        }
+        return *this;
+    }
+
+    void Mapping::resize(size_t bytes)
+    {
+        if (bytes == m_bytes) {
+            return;
+        }
+
+        if (bytes == 0) {
+            release();
+        }
+        else if (m_address == nullptr) {
+            m_address = map(bytes, m_pageSize);
+        }
+        else {
+            m_address = remap(m_address, m_bytes, bytes, m_pageSize);
+        }
+        m_bytes = bytes;
+    }
+
+    void Mapping::release() noexcept
+    {
+        if (m_address != nullptr) {
+            unmap(m_address, m_bytes);
+            m_address = nullptr;
+            m_bytes = 0;
+        }
+    }
+}
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -0,0 +1,54 @@
+// ===============================================================================
+// Large Buffers Directly from the Operating System (mmap / VirtualAlloc)
+// ===============================================================================
+
+#pragma once
+
+#include <cstddef>
+
+namespace MappedMemory {
+
+    // 'Huge': transparent huge pages via madvise(MADV_HUGEPAGE) on Linux,
+    // elsewhere the request is ignored
+    enum class PageSize { Normal, Huge };
+
+    // anonymous mapping: the pages are zero-filled by the operating system
+    // on first access ("lazy zeroing"), untouched pages cost no physical memory
+    class Mapping
+    {
+    private:
+        void* m_address;
+        size_t m_bytes;
+        PageSize m_pageSize;
+
+    public:
+        // c'tors and d'tor
+        Mapping() noexcept;
+        Mapping(size_t bytes, PageSize pageSize);
+        ~Mapping();
+
+        // move-only
+        Mapping(const Mapping&) = delete;
+        Mapping& operator= (const Mapping&) = delete;
+        Mapping(Mapping&& other) noexcept;
+        Mapping& operator= (Mapping&& other) noexcept;
+
+        // keeps the contents, new bytes are zero;
+        // Linux: mremap moves the page table entries, no bytes are copied
+        void resize(size_t bytes);
+
+        // getter
+        void* data() const { return m_address; }
+        size_t bytes() const { return m_bytes; }
+        PageSize pageSize() const { return m_pageSize; }
+
+    private:
+        void release() noexcept;
+    };
+
+    size_t pageSize();
+}
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -0,0 +1,92 @@
+// ===============================================================================
+// Memory Usage of the Current Process
+// ===============================================================================
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+
+#include "ProcessMemory.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(__linux__)
+#include <sys/resource.h>
+#endif
+
+namespace ProcessMemory {
+
+#if defined(_WIN32)
+
+    Usage current()
+    {
+        PROCESS_MEMORY_COUNTERS counters{};
+        counters.cb = sizeof(counters);
+        if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters))) {
+            return Usage{};
+        }
+
+        return Usage{ counters.WorkingSetSize, counters.PeakWorkingSetSize, counters.PageFaultCount, 0 };
+    }
+
+    bool resetPeak()
+    {
+        return false;
+    }
+
+#elif defined(__linux__)
+
+    // "VmRSS:" and "VmHWM:" of /proc/self/status, in bytes
+    static size_t statusValue(const std::string& key)
+    {
+        std::ifstream status{ "/proc/self/status" };
+        std::string line;
+        while (std::getline(status, line)) {
+            if (line.compare(0, key.size(), key) == 0) {
+                return std::stoull(line.substr(key.size())) * 1024;
+            }
+        }
+        return 0;
+    }
+
+    Usage current()
+    {
+        struct rusage usage{};
+        ::getrusage(RUSAGE_SELF, &usage);
+
+        return Usage{
+            statusValue("VmRSS:"),
+            statusValue("VmHWM:"),
+            static_cast<size_t>(usage.ru_minflt),
+            static_cast<size_t>(usage.ru_majflt)
+        };
+    }
+
+    bool resetPeak()
+    {
+        std::ofstream clearRefs{ "/proc/self/clear_refs" };
+        clearRefs << "5";
+        clearRefs.close();
+        return !clearRefs.fail();
+    }
+
+#else
+
+    Usage current()
+    {
+        return Usage{};
+    }
+
+    bool resetPeak()
+    {
+        return false;
+    }
+
+#endif
+}
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
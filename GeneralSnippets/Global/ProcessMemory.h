@@ -0,0 +1,28 @@
+// ===============================================================================
+// Memory Usage of the Current Process
+// ===============================================================================
+
+#pragma once
+
+#include <cstddef>
+
+namespace ProcessMemory {
+
+    struct Usage
+    {
+        size_t residentBytes;       // current working set (0 if unknown)
+        size_t peakResidentBytes;   // high-water mark of the working set
+        size_t minorFaults;         // page faults served without I/O (Windows: all page faults)
+        size_t majorFaults;         // page faults that needed I/O (Windows: 0)
+    };
+
+    Usage current();
+
+    // starts a new high-water mark, returns false if the platform cannot do so
+    // (Linux: /proc/self/clear_refs, Windows: not supported)
+    bool resetPeak();
+}
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -0,0 +1,26 @@
+// ===============================================================================
+// Trivially Relocatable Types
+// ===============================================================================
+
+#pragma once
+
+#include <type_traits>
+
+// A type is "trivially relocatable" if moving an object to a new address and
+// destroying the source is the same as copying its bytes (memcpy) and forgetting
+// the source. Trivially copyable types are, most classes owning heap memory
+// through a plain pointer (no pointer into the object itself) are, too.
+// Such classes opt in by a specialization next to their definition:
+//
+//     template <>
+//     struct is_trivially_relocatable<MyClass> : std::true_type {};
+
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+// ===============================================================================
+// End-of-File
+// ===============================================================================
@@ -3,31 +3,52 @@
 // =====================================================================================
 
 #include <iostream>
+#include <iomanip>
 #include <vector>
+#include <array>
 #include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "../Global/Benchmark.h"
+#include "../Global/CowBuffer.h"
+#include "../Global/Dummy.h"
+#include "../Global/TriviallyRelocatable.h"
 
 #include "MoveSemantics.h"
 
 namespace MoveSemantics {
 
     // c'tors and d'tor
-    BigData::BigData() {
-        // empty buffer
-        m_size = 0;
-        m_data = nullptr;
+    // note: whenever the buffer is inline, 'm_inline' is the active member of the union
+    // and value-initialized - moving an object copies it as a whole
+
+    BigData::BigData() : m_size{ 0 }, m_inline{} {
+        // empty buffer, stored inline
     }
 
     BigData::BigData(size_t size, int preset) {
-        // empty buffer
+        // allocate buffer, unless it fits into the object
         m_size = size;
-        m_data = new int[m_size];
+        if (isInline()) {
+            m_inline = {};
+        }
+        else {
+            m_data = new int[m_size];
+        }
 
         // initialize object
-        std::fill(m_data, m_data + m_size, preset);
+        std::fill(data(), data() + m_size, preset);
     }
 
     BigData::~BigData() {
-        delete[] m_data;
+        if (!isInline()) {
+            delete[] m_data;
+        }
     }
 
     // copy semantics
@@ -35,10 +56,15 @@ namespace MoveSemantics {
 
         // allocate buffer
         m_size = data.m_size;
-        m_data = new int[m_size];
+        if (isInline()) {
+            m_inline = {};
+        }
+        else {
+            m_data = new int[m_size];
+        }
 
         // copy object
-        std::copy(data.m_data, data.m_data + m_size, m_data);
+        std::copy(data.data(), data.data() + m_size, this->data());
     }
 
     BigData& BigData::operator= (const BigData& data) {
@@ -47,25 +73,34 @@ namespace MoveSemantics {
         if (this == &data)
             return *this;
 
-        // delete old buffer
-        delete[] m_data;
+        // allocate a new buffer first: if 'new' throws, the object is unchanged
+        int* buffer = data.isInline() ? nullptr : new int[data.m_size];
+
+        // delete old buffer, 'm_inline' becomes active
+        cleanup();
 
-        // allocate a new buffer
         m_size = data.m_size;
-        m_data = new int[m_size];
+        if (!isInline()) {
+            m_data = buffer;
+        }
 
         // copy buffer
-        std::copy(data.m_data, data.m_data + m_size, m_data);
+        std::copy(data.data(), data.data() + m_size, this->data());
 
         return *this;
     }
 
     // move semantics
     BigData::BigData(BigData&& data) noexcept {  // move c'tor
-        m_data = data.m_data;   // shallow copy
         m_size = data.m_size;
-        data.m_data = nullptr;  // reset source object, ownership has been moved
-        data.m_size = 0;
+        if (data.isInline()) {
+            m_inline = data.m_inline;  // copy of a few bytes, no heap involved
+        }
+        else {
+            m_data = data.m_data;      // shallow copy
+            data.m_inline = {};        // source is empty and inline now
+        }
+        data.m_size = 0;               // reset source object, ownership has been moved
     }
 
     // first alternate realisation
@@ -80,11 +115,18 @@ namespace MoveSemantics {
 
     BigData& BigData::operator= (BigData&& data) noexcept { // move-assignment
         if (this != &data) {
-            delete[] m_data;        // release left side
-            m_data = data.m_data;   // shallow copy
+            if (!isInline()) {
+                delete[] m_data;           // release left side
+            }
             m_size = data.m_size;
-            data.m_data = nullptr;  // reset source object, ownership has been moved
-            data.m_size = 0;
+            if (data.isInline()) {
+                m_inline = data.m_inline;  // copy of a few bytes, no heap involved
+            }
+            else {
+                m_data = data.m_data;      // shallow copy
+                data.m_inline = {};        // source is empty and inline now
+            }
+            data.m_size = 0;               // reset source object, ownership has been moved
         }
         return *this;
     }
@@ -118,38 +160,61 @@ namespace MoveSemantics {
         return m_size == 0;
     }
 
+    bool BigData::isInline() const {
+        return m_size <= BigDataInlineCapacity;
+    }
+
+    int* BigData::data() {
+        return isInline() ? m_inline.data() : m_data;
+    }
+
+    const int* BigData::data() const {
+        return isInline() ? m_inline.data() : m_data;
+    }
+
     // private helper methods
     void BigData::cleanup() noexcept {
-        delete[] m_data;
-        m_data = nullptr;
+        if (!isInline()) {
+            delete[] m_data;
+        }
         m_size = 0;
+        m_inline = {};
     }
 
     void BigData::moveFrom(BigData& data) noexcept {
-        // shallow copy
-        m_data = data.m_data;
+        // shallow copy - or copy of the inline buffer
         m_size = data.m_size;
+        if (data.isInline()) {
+            m_inline = data.m_inline;
+        }
+        else {
+            m_data = data.m_data;
+            data.m_inline = {};
+        }
 
         // reset source  object, because ownership has been moved
-        data.m_data = nullptr;
         data.m_size = 0;
     }
 
     void BigData::swap(BigData& data1, BigData& data2) noexcept {  // 'swap idiom'
-        std::swap(data1.m_data, data2.m_data);
-        std::swap(data1.m_size, data2.m_size);
+        // inline buffers cannot be exchanged by swapping pointers
+        BigData tmp;
+        tmp.moveFrom(data1);
+        data1.moveFrom(data2);
+        data2.moveFrom(tmp);
     }
 
     // output operator
     std::ostream& operator<< (std::ostream& os, const BigData& data) {
         constexpr bool verbose = false;
 
-        os << "Size: " << data.m_size << " - Data at " << data.m_data;
+        os << "Size: " << data.m_size << " - Data at " << data.data()
+            << (data.isInline() ? " (inline)" : "");
         if constexpr (verbose) {
             os << std::endl;
             os << "{";
             for (size_t i = 0; i < data.m_size; i++) {
-                os << data.m_data[i];
+                os << data.data()[i];
                 if (i < data.m_size - 1)
                     os << ',';
             }
@@ -158,6 +223,42 @@ namespace MoveSemantics {
         return os;
     }
 
+    // =================================================================================
+    // copy-on-write variant
+
+    // c'tors
+    SharedBigData::SharedBigData() {}
+
+    SharedBigData::SharedBigData(size_t size, int preset) : m_buffer(size, preset) {}
+
+    // getter
+    size_t SharedBigData::size() const {
+        return m_buffer.size();
+    }
+
+    bool SharedBigData::isEmpty() const {
+        return m_buffer.size() == 0;
+    }
+
+    bool SharedBigData::isShared() const {
+        return m_buffer.isShared();
+    }
+
+    const int* SharedBigData::data() const {
+        return m_buffer.data();
+    }
+
+    int* SharedBigData::mutableData() {
+        return m_buffer.mutableData();
+    }
+
+    // output operator
+    std::ostream& operator<< (std::ostream& os, const SharedBigData& data) {
+        os << "Size: " << data.size() << " - Data at " << data.data()
+            << (data.isShared() ? " (shared)" : "");
+        return os;
+    }
+
     // test methods
     BigData createHugeData() {
         BigData data(10, 1);
@@ -192,6 +293,212 @@ namespace MoveSemantics {
         BigData data11;
         data11 = std::move(data1);
     }
+
+    void test_03_move_semantics_small_buffer() {
+
+        BigData small(10, 1);   // fits into the object
+        BigData large(100, 2);  // on the heap
+        std::cout << small << std::endl;
+        std::cout << large << std::endl;
+
+        // moving an inline buffer copies the elements, the source becomes empty
+        BigData moved(std::move(small));
+        std::cout << moved << std::endl;
+        std::cout << small << std::endl;
+
+        // assignments between inline and heap buffers in both directions
+        small = large;
+        std::cout << small << std::endl;
+        large = moved;
+        std::cout << large << std::endl;
+    }
+
+    // =================================================================================
+    // benchmark: std::vector<BigData> - shuffle, copy and sort, payload lengths 1..n
+
+    template <typename TPayload>
+    std::vector<TPayload> makePayloads(size_t count, size_t maxLength) {
+
+        std::mt19937 generator{ 42 };
+        std::uniform_int_distribution<size_t> length{ 1, maxLength };
+        std::uniform_int_distribution<int> value{ 0, 1000 };
+
+        std::vector<TPayload> payloads;
+        payloads.reserve(count);
+        for (size_t i{}; i != count; ++i) {
+            payloads.emplace_back(length(generator), 0);
+            for (size_t k{}; k != payloads.back().size(); ++k) {
+                payloads.back().data()[k] = value(generator);
+            }
+        }
+        return payloads;
+    }
+
+    template <typename TPayload>
+    bool lessPayload(const TPayload& left, const TPayload& right) {
+        return std::lexicographical_compare(
+            left.data(), left.data() + left.size(),
+            right.data(), right.data() + right.size());
+    }
+
+    template <typename TPayload>
+    void addPayloadCases(Benchmarking::Benchmark& benchmark, const std::string& name) {
+
+        constexpr size_t Count = 100000;
+
+        benchmark.add(name + ", shuffle", [](size_t maxLength) -> Benchmarking::Benchmark::Function {
+            auto payloads{ std::make_shared<std::vector<TPayload>>(makePayloads<TPayload>(Count, maxLength)) };
+            auto generator{ std::make_shared<std::mt19937>(4711) };
+            return [=]() {
+                std::shuffle(std::begin(*payloads), std::end(*payloads), *generator);
+                Benchmarking::doNotOptimize(payloads->front());
+            };
+        });
+
+        // deep copies: here inline buffers save the heap allocations
+        benchmark.add(name + ", copy", [](size_t maxLength) -> Benchmarking::Benchmark::Function {
+            auto payloads{ std::make_shared<std::vector<TPayload>>(makePayloads<TPayload>(Count, maxLength)) };
+            return [=]() {
+                std::vector<TPayload> copy{ *payloads };
+                Benchmarking::doNotOptimize(copy.front());
+            };
+        });
+
+        benchmark.add(name + ", shuffle + sort", [](size_t maxLength) -> Benchmarking::Benchmark::Function {
+            auto payloads{ std::make_shared<std::vector<TPayload>>(makePayloads<TPayload>(Count, maxLength)) };
+            auto generator{ std::make_shared<std::mt19937>(4711) };
+            return [=]() {
+                std::shuffle(std::begin(*payloads), std::end(*payloads), *generator);
+                std::sort(std::begin(*payloads), std::end(*payloads), lessPayload<TPayload>);
+                Benchmarking::doNotOptimize(payloads->front());
+            };
+        });
+    }
+
+    void test_05_move_semantics_copy_on_write() {
+
+        SharedBigData data1(10000000, 1);
+        std::cout << data1 << std::endl;
+
+        // O(1) copies for readers
+        SharedBigData data2(data1);
+        SharedBigData data3;
+        data3 = data1;
+        std::cout << data2 << std::endl;
+        std::cout << data3 << std::endl;
+
+        // the first write access copies the buffer
+        data3.mutableData()[0] = 2;
+        std::cout << data3 << std::endl;
+        std::cout << data1 << std::endl;
+
+        // moving never copies
+        SharedBigData data4(std::move(data3));
+        std::cout << data4 << std::endl;
+    }
+
+    // concurrent readers of shared copies, one writer detaching its own copy
+    void test_06_move_semantics_copy_on_write_threads() {
+
+        constexpr size_t Size = 1000000;
+        constexpr int Readers = 4;
+        constexpr int Rounds = 50;
+
+        const SharedBigData source(Size, 1);
+        std::atomic<bool> failed{ false };
+
+        std::vector<std::thread> threads;
+        for (int reader = 0; reader < Readers; ++reader) {
+            threads.emplace_back([&]() {
+                for (int round = 0; round < Rounds; ++round) {
+                    SharedBigData copy(source);   // copying a shared const object concurrently is safe
+                    long long sum{ std::accumulate(copy.data(), copy.data() + copy.size(), 0LL) };
+                    if (sum != static_cast<long long>(Size)) {
+                        failed = true;
+                    }
+                }
+            });
+        }
+
+        threads.emplace_back([&]() {
+            for (int round = 0; round < Rounds; ++round) {
+                SharedBigData copy(source);
+                int* data{ copy.mutableData() };  // detaches, 'source' is not affected
+                std::fill(data, data + copy.size(), 2);
+                if (copy.isShared() || copy.data()[0] != 2) {
+                    failed = true;
+                }
+            }
+        });
+
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+
+        std::cout << "readers: " << Readers << ", writer: 1, rounds: " << Rounds
+            << ", source shared afterwards: " << std::boolalpha << source.isShared()
+            << ", " << (failed ? "FAILED" : "ok") << std::endl;
+    }
+
+    void test_04_move_semantics_small_buffer_benchmark() {
+
+        std::cout << "sizeof(BigData): " << sizeof(BigData)
+            << ", inline capacity: " << BigDataInlineCapacity << std::endl;
+
+        Benchmarking::Benchmark benchmark{ "100000 payloads, lengths 1..n: BigData vs. std::vector<int> (always on the heap)" };
+
+        addPayloadCases<BigData>(benchmark, "BigData");
+        addPayloadCases<std::vector<int>>(benchmark, "std::vector<int>");
+
+        // n = 16: all inline, n = 64: a quarter inline, n = 256: almost all on the heap
+        benchmark.run({ 8, 16, 64, 256 });
+    }
+
+    // =================================================================================
+    // regression checks: counting the copies and moves of 'Dummy' objects
+
+    static Dummy makeDummy(int value) {
+        Dummy dummy(value);
+        return dummy;   // NRVO or move, never a copy
+    }
+
+    void test_07_move_semantics_regression() {
+
+        RegressionCheck<Dummy> check{ "Move Semantics" };
+
+        {
+            CountingScope<Dummy> scope;
+            Dummy dummy{ makeDummy(1) };
+            check(expect_no_copies(scope.counts(), "return by value"));
+        }
+
+        {
+            Dummy dummy1(1);
+            Dummy dummy2(2);
+            CountingScope<Dummy> scope;
+            std::swap(dummy1, dummy2);
+            check(expect_copies_and_moves(scope.counts(), 0, 3, "std::swap"));
+        }
+
+        {
+            std::vector<Dummy> source;
+            source.reserve(10);
+            for (int n = 0; n < 10; ++n) {
+                source.emplace_back(n);
+            }
+            CountingScope<Dummy> scope;
+            std::vector<Dummy> target{ std::move(source) };
+            check(expect_in_place(scope.counts(), "moving a std::vector<Dummy>"));
+        }
+
+        {
+            // 'std::move' of a const object silently selects the copy c'tor
+            const Dummy source(1);
+            CountingScope<Dummy> scope;
+            Dummy target{ std::move(source) };
+            check(expect_copies(scope.counts(), 1, "std::move of a const object"));
+        }
+    }
 }
 
 void main_move_semantics()
@@ -199,6 +506,11 @@ void main_move_semantics()
     using namespace MoveSemantics;
     test_01_move_semantics();
     test_02_move_semantics();
+    test_03_move_semantics_small_buffer();
+    test_04_move_semantics_small_buffer_benchmark();
+    test_05_move_semantics_copy_on_write();
+    test_06_move_semantics_copy_on_write_threads();
+    test_07_move_semantics_regression();
 }
 
 // =====================================================================================
@@ -1,11 +1,18 @@
 namespace MoveSemantics {
 
+    // buffers with up to 'BigDataInlineCapacity' elements are stored inside the object
+    // ("small buffer optimization"), 0 means: always on the heap
+    constexpr size_t BigDataInlineCapacity = 16;
+
     class BigData
     {
     private:
         // private member data
         size_t m_size;  // current number of elements
-        int* m_data;    // array of elements
+        union {
+            int* m_data;                                      // array of elements on the heap
+            std::array<int, BigDataInlineCapacity> m_inline;  // or inline, if m_size <= BigDataInlineCapacity
+        };
 
     public:
         // c'tors and d'tor
@@ -31,8 +38,44 @@ namespace MoveSemantics {
         // getter
         size_t size() const;
         bool isEmpty() const;
+        bool isInline() const;
+        int* data();
+        const int* data() const;
 
         // output operator
         friend std::ostream& operator<< (std::ostream&, const BigData&);
     };
-}
\ No newline at end of file
+
+    // opt-in alternative to 'BigData': copies share the buffer (copy-on-write),
+    // the buffer is copied on the first mutable access of a shared object
+    class SharedBigData
+    {
+    private:
+        // private member data
+        CowBuffer<int> m_buffer;  // size, elements and atomic reference count
+
+    public:
+        // c'tors - copy and move semantics of 'CowBuffer' ("Rule of Zero")
+        SharedBigData();
+        SharedBigData(size_t, int);
+
+    public:
+        // getter
+        size_t size() const;
+        bool isEmpty() const;
+        bool isShared() const;
+        const int* data() const;
+
+        // copies the buffer if it is shared,
+        // the pointer must not be used any more once the object has been copied
+        int* mutableData();
+
+        // output operator
+        friend std::ostream& operator<< (std::ostream&, const SharedBigData&);
+    };
+}
+
+// 'BigData' holds a size and either a heap pointer or an inline buffer:
+// moving it by memcpy and forgetting the source is a valid move
+template <>
+struct is_trivially_relocatable<MoveSemantics::BigData> : std::true_type {};
\ No newline at end of file
@@ -39,12 +39,59 @@ namespace PerfectForwardingObject {
         Dummy dummy(1);
         forwarding(dummy);
     }
+
+    // =================================================================================
+    // regression checks: a forwarding function must not add copies
+
+    template <typename T>
+    Dummy makeDummy(T&& arg) {
+        return Dummy(std::forward<T>(arg));
+    }
+
+    template <typename T>
+    Dummy makeDummyWithoutForward(T&& arg) {
+        return Dummy(arg);   // 'arg' is an lvalue: always copies
+    }
+
+    void test_02() {
+
+        RegressionCheck<Dummy> check{ "Perfect Forwarding" };
+
+        {
+            CountingScope<Dummy> scope;
+            std::cout.setstate(std::ios::badbit);   // mute the "By ..." output of 'forwarding'
+            forwarding(Dummy(1));
+            std::cout.clear();
+            check(expect_in_place(scope.counts(), "forwarding to references"));
+        }
+
+        {
+            CountingScope<Dummy> scope;
+            Dummy dummy{ makeDummy(Dummy(1)) };
+            check(expect_copies_and_moves(scope.counts(), 0, 1, "std::forward - RValue"));
+        }
+
+        {
+            Dummy source(1);
+            CountingScope<Dummy> scope;
+            Dummy dummy{ makeDummy(source) };
+            check(expect_copies_and_moves(scope.counts(), 1, 0, "std::forward - LValue"));
+        }
+
+        {
+            // the price of a missing 'std::forward': the temporary is copied
+            CountingScope<Dummy> scope;
+            Dummy dummy{ makeDummyWithoutForward(Dummy(1)) };
+            check(expect_copies(scope.counts(), 1, "without std::forward - RValue"));
+        }
+    }
 }
 
 void main_perfect_forwarding_object()
 {
     using namespace PerfectForwardingObject;
     test_01();
+    test_02();
 }
 
 // =====================================================================================
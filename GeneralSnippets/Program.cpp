@@ -4,10 +4,17 @@
 
 #include <iostream>
 
+#include "Global/InstanceCounter.h"
+
 // main entry points code snippets
 void main_accumulate();
 void main_allocator_classtype();
 void main_allocator_integral();
+void main_allocator_pool();
+void main_allocator_arena();
+void main_allocator_thread_cache();
+void main_allocator_statistics();
+void main_allocator_growth_vector();
 void main_any();
 void main_apply_integer_sequence();
 void main_array();
@@ -29,6 +36,7 @@ void main_filesystem();
 void main_filesystem();
 void main_functional_programming();
 void main_functional_programming_alternate();
+void main_functional_programming_columnar();
 void main_function_templates_basics();
 void main_initializer_list();
 void main_input_output_streams();
@@ -95,6 +103,11 @@ int main()
         //main_accumulate();
         //main_allocator_classtype();
         //main_allocator_integral();
+        //main_allocator_pool();
+        //main_allocator_arena();
+        //main_allocator_thread_cache();
+        //main_allocator_statistics();
+        //main_allocator_growth_vector();
         //main_any();
         //main_apply_integer_sequence();
         //main_array();
@@ -116,6 +129,7 @@ int main()
         //main_filesystem();
         //main_functional_programming();
         //main_functional_programming_alternate();
+        //main_functional_programming_columnar();
         //main_function_templates_basics();
         //main_initializer_list();
         //main_input_output_streams();
@@ -178,7 +192,9 @@ int main()
     }
 
     std::cout << "[Done.]" << std::endl;
-    return 0;
+
+    // regression checks of copies and moves, see 'RegressionCheck'
+    return regressionFailures() == 0 ? 0 : 1;
 }
 
 // =====================================================================================